@@ -8,108 +8,65 @@
 #include <string>
 #include <vector>
 
+#include "counting_sort.h"
 #include "sort.h"
 #include "utils.h"
 
 // ------------------------ Algorithm Code ------------------------
 
-int find_max(const int n, const int data[]) {
-  int max = data[0];
+// The counting sorts are implemented by sort_lib, see counting_sort.h
 
-  for (int i = 1; i < n; i++) {
-    if (data[i] > max) {
-      max = data[i];
-    }
-  }
-
-  return max;
-}
+// ------------------------ Benchmarking Code ------------------------
 
-int find_min(const int n, const int data[]) {
-  int min = data[0];
+long long benchmark_algorithm(const int n, int data[], BenchmarkArena *arena) {
+  // Reuse the buffers of the arena to avoid the overhead of malloc
+  const int max = sort_lib::find_max(n, data);
+  const int min = sort_lib::find_min(n, data);
+  const int k = max - min + 1;
 
-  for (int i = 1; i < n; i++) {
-    if (data[i] < min) {
-      min = data[i];
-    }
-  }
+  auto *out = arena->get<int>(OUT_BUFFER, n);
+  auto *count = arena->get<int>(COUNT_BUFFER, k);
 
-  return min;
+  // The input is only read, so there is nothing to prepare. The count array is
+  // cleared in the timed call, as the blocked and parallel sorts do
+  return measure_algorithm(1, [](int) {}, [&](int) {
+    memset(count, 0, k * sizeof(int));
+    // Call the sort function
+    sort_lib::counting_sort(n, k, data, out, count);
+  });
 }
 
-void counting_sort(const int n, const int k, const int data[], int out[],
-                   int count[]) {
-  // Find the minimum and maximum elements of the array
-  int min_val = data[0];
-
-  for (int i = 1; i < n; i++) {
-    if (data[i] < min_val) {
-      min_val = data[i];
-    }
-  }
-
-  // Count occurrences of each element
-  for (int i = 0; i < n; i++) {
-    count[data[i] - min_val]++;
-  }
+long long benchmark_blocked_algorithm(const int n, int data[], BenchmarkArena *arena) {
+  // Reuse the buffers of the arena to avoid the overhead of malloc
+  const int max = sort_lib::find_max(n, data);
+  const int min = sort_lib::find_min(n, data);
+  const int k = max - min + 1;
 
-  // Calculate cumulative count
-  for (int i = 1; i < k; i++) {
-    count[i] += count[i - 1];
-  }
+  auto *out = arena->get<int>(OUT_BUFFER, n);
+  auto *buffer = arena->get<int>(TEMP_BUFFER, n);
+  auto *count = arena->get<int>(COUNT_BUFFER, sort_lib::blocked_count_length(k));
 
-  // Build the output array
-  for (int i = n - 1; i >= 0; i--) {
-    out[count[data[i] - min_val] - 1] = data[i];
-    count[data[i] - min_val]--;
-  }
+  // The input is only read, so there is nothing to prepare
+  return measure_algorithm(1, [](int) {}, [&](int) {
+    // Call the sort function, which clears the count array by itself
+    sort_lib::blocked_counting_sort(n, k, data, out, count, buffer);
+  });
 }
 
-// ------------------------ Benchmarking Code ------------------------
-
-long long benchmark_algorithm(const int n, int data[]) {
-  // Pre allocate the memory to avoid the overhead of malloc
-  const int max = find_max(n, data);
-  const int min = find_min(n, data);
+long long benchmark_parallel_algorithm(const int n, int data[], BenchmarkArena *arena, TaskPool *pool) {
+  // Reuse the buffers of the arena to avoid the overhead of malloc
+  const int max = sort_lib::find_max(n, data);
+  const int min = sort_lib::find_min(n, data);
   const int k = max - min + 1;
 
-  auto *data_copy = new int[n];
-  auto *out = new int[n];
-  auto *count = new int[k];
-
-  // Get the resolution of the clock
-  const auto min_time = get_minimum_time();
-
-  // Initialize the clock to measure the execution time
-  long long elapsed = 0;
-  // Measure the elapsed time
-  int i = 0; // Counter to measure the number of iterations
-  const time_point_t start =
-      std::chrono::steady_clock::now(); // Start the clock
-  while (elapsed < min_time) { // Continue until the minimum time is reached
-    // Increment the counter
-    i++;
-
-    // Duplicate the input data
-    memcpy(data_copy, data, n * sizeof(int));
-    // Clear the arrays
-    memset(out, 0, n * sizeof(int));
-    memset(count, 0, k * sizeof(int));
-
-    // Call the sort function
-    counting_sort(n, k, data, out, count);
-    // Measure the elapsed time
-    time_point_t end = std::chrono::steady_clock::now();
-    elapsed = std::chrono::duration_cast<time_unit_t>(end - start).count();
-  }
+  auto *out = arena->get<int>(OUT_BUFFER, n);
+  auto *counts = arena->get<int>(COUNT_BUFFER, static_cast<long long>(pool->size()) * k);
 
-  // Free the allocated memory
-  delete[] out;
-  delete[] count;
-  delete[] data_copy;
-
-  // Compute the elapsed time in nanoseconds
-  return elapsed / i;
+  // The input is only read, so there is nothing to prepare
+  return measure_algorithm(1, [](int) {}, [&](int) {
+    // Call the sort function, which clears the count arrays by itself
+    sort_lib::parallel_counting_sort(n, k, data, out, counts, pool);
+  });
 }
 
 // ------------------------ Main Function ------------------------
@@ -124,19 +81,43 @@ int main(int argc, char *argv[]) {
   const int n = data.size();
   auto *arr = data.data();
 
-  const int max = find_max(n, arr);
-  const int min = find_min(n, arr);
-  const int k = max - min + 1;
+  // An empty array has no key range
+  const int k =
+      n > 0 ? sort_lib::find_max(n, arr) - sort_lib::find_min(n, arr) + 1 : 1;
+
+  // Select the variant of the algorithm
+  const std::string variant = get_option(argc, argv, "variant", "standard");
+  if (variant != "standard" && variant != "blocked") {
+    std::cerr << "Unknown variant: " << variant << std::endl;
+    return 1;
+  }
+  const bool blocked = variant == "blocked";
+  const int num_threads = std::stoi(get_option(argc, argv, "threads", "1"));
+  if (num_threads > 1 && blocked) {
+    std::cerr << "The blocked variant has no parallel version" << std::endl;
+    return 1;
+  }
 
   // Pre allocate the memory
   auto *out = new int[n];
-  auto *count = new int[k];
+  auto *count = new int[static_cast<long long>(num_threads) * k];
   // Initialize the arrays
   memset(out, 0, n * sizeof(int));
   memset(count, 0, k * sizeof(int));
 
-  // Execute the sort algorithm
-  counting_sort(n, k, arr, out, count);
+  // Execute the sort algorithm, in parallel if a thread count is given
+  if (num_threads > 1) {
+    TaskPool pool(num_threads);
+    sort_lib::parallel_counting_sort(n, k, arr, out, count, &pool);
+  } else if (blocked) {
+    auto *buffer = new int[n];
+    auto *blocked_count = new int[sort_lib::blocked_count_length(k)];
+    sort_lib::blocked_counting_sort(n, k, arr, out, blocked_count, buffer);
+    delete[] buffer;
+    delete[] blocked_count;
+  } else {
+    sort_lib::counting_sort(n, k, arr, out, count);
+  }
 
   // Print the sorted array
   for (int i = 0; i < n; i++) {
@@ -153,35 +134,89 @@ int main(int argc, char *argv[]) {
 #else
 
 int main(const int argc, char *argv[]) {
-  set_cpu_affinity();
+  const std::vector<std::string> args = get_positional_arguments(argc, argv);
 
-  if (argc < 2) {
+  if (args.size() < 2) {
     std::cerr << "Usage: " << argv[0]
               << " [length|max] [linear|exponential] [output_file]"
+                 " [--threads=N] [--variant=standard|blocked] [--max-length=N]"
+                 " [--max-max=N]"
+                 " [--order=random|sorted|reversed|organ_pipe|nearly_sorted|shuffled_runs]"
+                 " [--seed=N] [--huge-pages] [--counters] [--timing=total|sort] [--cores=LIST]"
               << std::endl;
     return 1;
   }
 
-  const std::string mode = argv[1];
+  // Select the variant of the algorithm
+  const std::string variant = get_option(argc, argv, "variant", "standard");
+  if (variant != "standard" && variant != "blocked") {
+    std::cerr << "Unknown variant: " << variant << std::endl;
+    return 1;
+  }
+  const bool blocked = variant == "blocked";
+
+  // Select the order of the input data
+  const std::string order = get_option(argc, argv, "order", "random");
+  if (!is_valid_input_order(order)) {
+    std::cerr << "Unknown input order: " << order << std::endl;
+    return 1;
+  }
+
+  // Generate the same input data as the other executables run with the same seed
+  const std::string seed = get_option(argc, argv, "seed", "");
+  if (!seed.empty()) {
+    set_input_seed(std::stoul(seed));
+  }
+
+  // The parallel sort runs on all the requested cores, so the process is not
+  // pinned to the first one
+  const std::string threads_option = get_option(argc, argv, "threads", "");
+  const bool parallel = !threads_option.empty();
+  const int num_threads = parallel ? std::stoi(threads_option) : 1;
+  if (parallel && blocked) {
+    std::cerr << "The blocked variant has no parallel version" << std::endl;
+    return 1;
+  }
+  if (parallel) {
+    set_process_priority();
+  } else {
+    set_cpu_affinity();
+  }
+
+  const std::string mode = args[1];
   const bool test_length = (mode == "length");
 
   // Default to exponential scaling if not specified
   bool linear_scaling = false;
-  if (argc >= 3) {
-    const std::string scaling_mode = argv[2];
+  if (args.size() >= 3) {
+    const std::string scaling_mode = args[2];
     linear_scaling = (scaling_mode == "linear");
   }
 
   // Output filename
   std::string output_file;
-  if (argc >= 4) {
-    output_file = argv[3];
+  if (args.size() >= 4) {
+    output_file = args[3];
   } else {
     // Generate a filename based on test parameters and timestamp
+    std::string sort_type = "counting_sort";
+    if (blocked) {
+      sort_type = "blocked_" + sort_type;
+    }
+    if (parallel) {
+      sort_type = "parallel_" + sort_type;
+    }
+    if (order != "random") {
+      sort_type += "_" + order;
+    }
     output_file = generate_filename(test_length ? "length" : "max",
-                                    linear_scaling, "counting_sort");
+                                    linear_scaling, sort_type);
   }
 
+  // Create the pool once, so that the threads are not started in the timed
+  // loop
+  TaskPool pool(num_threads);
+
   std::vector<RunResult> runs;
 
   // Determine which parameter to vary and its range
@@ -189,11 +224,13 @@ int main(const int argc, char *argv[]) {
   bool vary_length;
   if (test_length) {
     min_param = 100;    // min_length
-    max_param = 100000; // max_length
+    max_param = std::stoi(
+        get_option(argc, argv, "max-length", "100000")); // max_length
     vary_length = true;
   } else {
     min_param = 10;      // min_max
-    max_param = 1000000; // max_max
+    max_param = std::stoi(
+        get_option(argc, argv, "max-max", "1000000")); // max_max
     vary_length = false;
   }
 
@@ -201,8 +238,51 @@ int main(const int argc, char *argv[]) {
   std::vector<int> sample_points =
       generate_sample_points(min_param, max_param, NUM_SAMPLES, linear_scaling);
 
-  // Run tests for each sample point
-  for (const int param_value : sample_points) {
+  // Allocate the buffers once for the largest arrays of the sweep
+  BenchmarkArena arena((vary_length ? max_param : 100000) * sizeof(int),
+                       has_flag(argc, argv, "huge-pages"));
+
+  // Count the hardware events of the timed loops if requested
+  if (has_flag(argc, argv, "counters")) {
+    // The counters only follow the calling thread, they would miss the work of
+    // the other threads of the pool
+    if (parallel) {
+      std::cerr << "The hardware counters only count the calling thread, "
+                   "--counters cannot be used with --threads"
+                << std::endl;
+      return 1;
+    }
+    enable_perf_counters();
+  }
+
+  // Select whether the timed loops measure the copies of the input or only
+  // the sorts
+  const std::string timing = get_option(argc, argv, "timing", "total");
+  TimingMode timing_mode;
+  if (!parse_timing_mode(timing, &timing_mode)) {
+    std::cerr << "Unknown timing mode: " << timing << std::endl;
+    return 1;
+  }
+  set_timing_mode(timing_mode);
+
+  // Shard the sample points across worker processes pinned to the given
+  // cores, if any
+  const std::string cores_option = get_option(argc, argv, "cores", "");
+  std::vector<int> cores;
+  if (!parse_core_list(cores_option, &cores)) {
+    std::cerr << "Invalid list of cores: " << cores_option << std::endl;
+    return 1;
+  }
+  if (parallel && !cores.empty()) {
+    std::cerr << "The workers of --cores are single-threaded, --threads "
+                 "cannot be used with --cores"
+              << std::endl;
+    return 1;
+  }
+
+  // Run tests for each sample point, sharded across the cores if requested
+  const bool completed = run_sweep(sample_points, cores, &runs,
+                                   [&](const int param_value) {
     RunResult run = {};
 
     if (vary_length) {
@@ -216,19 +296,30 @@ int main(const int argc, char *argv[]) {
     // Run multiple times for each sample point
     for (int r = 0; r < NUM_RUNS; r++) {
       // Generate input data with appropriate parameters
-      const auto data = new int[run.length];
+      const auto data = arena.get<int>(INPUT_BUFFER, run.length);
       generate_input_data(data, run.length, run.min, run.max);
+      arrange_input_data(data, run.length, order);
       // Execute and record time
-      run.time[r] = benchmark_algorithm(run.length, data);
-      // Free the allocated memory
-      delete[] data;
+      if (parallel) {
+        run.time[r] =
+            benchmark_parallel_algorithm(run.length, data, &arena, &pool);
+      } else if (blocked) {
+        run.time[r] = benchmark_blocked_algorithm(run.length, data, &arena);
+      } else {
+        run.time[r] = benchmark_algorithm(run.length, data, &arena);
+      }
+      add_perf_counters(&run);
+      add_copy_time(&run);
     }
 
     // Print results for this run
     std::cout << "Length: " << run.length << ", Min: " << run.min
               << ", Max: " << run.max << std::endl;
 
-    runs.push_back(run);
+    return run;
+  });
+  if (!completed) {
+    return 1;
   }
 
   // Write results to CSV file
@@ -1,40 +1,36 @@
 #ifndef COUNTING_SORT_H
 #define COUNTING_SORT_H
 
-/**
- * Find the maximum value in the array
- * @param n The length of the array
- * @param data The array of integers
- * @return The maximum value in the array
- */
-int find_max(int n, const int data[]);
+#include "arena.h"
+#include "task_pool.h"
 
 /**
- * Find the minimum value in the array
+ * Execute the sort algorithm
  * @param n The length of the array
  * @param data The array of integers
- * @return The minimum value in the array
+ * @param arena The buffers of the benchmark
+ * @return The execution time in nanoseconds
  */
-int find_min(int n, const int data[]);
+long long benchmark_algorithm(int n, int data[], BenchmarkArena *arena);
 
 /**
- * Perform counting sort on the input array
+ * Execute the blocked sort algorithm
  * @param n The length of the array
  * @param data The array of integers
- * @param out The output array
- * @param count The count array
- * @param k The length of the count array
+ * @param arena The buffers of the benchmark
  * @return The execution time in nanoseconds
  */
-void counting_sort(int n, int data[], int out[], int count[], int k);
+long long benchmark_blocked_algorithm(int n, int data[], BenchmarkArena *arena);
 
 /**
- * Execute the sort algorithm
+ * Execute the parallel sort algorithm
  * @param n The length of the array
  * @param data The array of integers
+ * @param arena The buffers of the benchmark
+ * @param pool The pool that executes the sort
  * @return The execution time in nanoseconds
  */
-long long benchmark_algorithm(int n, int data[]);
+long long benchmark_parallel_algorithm(int n, int data[], BenchmarkArena *arena, TaskPool *pool);
 
 /**
  * Main function to run the sort algorithm
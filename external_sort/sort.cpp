@@ -0,0 +1,611 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "counting_sort.h"
+#include "quick_sort.h"
+#include "sort.h"
+#include "tim_sort.h"
+#include "utils.h"
+
+// ------------------------ I/O Code ------------------------
+
+BlockReader::BlockReader(FILE *file, const int block_length)
+    : file(file), current(block_length), next(block_length) {
+    pending = std::async(std::launch::async, [this] { return fread(next.data(), sizeof(int), next.size(), this->file); });
+}
+
+BlockReader::~BlockReader() {
+    if (pending.valid()) {
+        pending.wait();
+    }
+}
+
+int BlockReader::next_block() {
+    const size_t length = pending.get();
+    if (ferror(file)) {
+        throw std::runtime_error("Cannot read the input of the merge");
+    }
+
+    // The block just read becomes current and the former current block receives the following one
+    std::swap(current, next);
+    if (length > 0) {
+        pending = std::async(std::launch::async, [this] { return fread(next.data(), sizeof(int), next.size(), file); });
+    } else {
+        // End of the file: return empty blocks from now on
+        pending = std::async(std::launch::deferred, [] { return static_cast<size_t>(0); });
+    }
+    return static_cast<int>(length);
+}
+
+const int *BlockReader::data() const {
+    return current.data();
+}
+
+BlockWriter::BlockWriter(FILE *file, const int block_length) : file(file), current(block_length), next(block_length) {}
+
+BlockWriter::~BlockWriter() {
+    if (pending.valid()) {
+        pending.wait();
+    }
+}
+
+void BlockWriter::flush() {
+    // The buffer of the previous write is reused for the next block
+    if (pending.valid() && !pending.get()) {
+        throw std::runtime_error("Cannot write the output of the merge");
+    }
+
+    std::swap(current, next);
+    const size_t count = length;
+    pending = std::async(std::launch::async, [this, count] {
+        return fwrite(next.data(), sizeof(int), count, file) == count;
+    });
+    length = 0;
+}
+
+void BlockWriter::close() {
+    flush();
+    if (!pending.get()) {
+        throw std::runtime_error("Cannot write the output of the merge");
+    }
+}
+
+// ------------------------ Algorithm Code ------------------------
+
+// Function to get an engine by name
+bool parse_engine(const std::string &name, ChunkEngine *engine) {
+    if (name == "tim_sort") {
+        *engine = TIM_SORT_ENGINE;
+    } else if (name == "quick_sort") {
+        *engine = QUICK_SORT_ENGINE;
+    } else if (name == "counting_sort") {
+        *engine = COUNTING_SORT_ENGINE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Function to parse a size with a K, M or G suffix
+bool parse_size(const std::string &text, long long *size) {
+    size_t end = 0;
+    long long value;
+    try {
+        value = std::stoll(text, &end);
+    } catch (const std::exception &) {
+        return false;
+    }
+
+    const std::string suffix = text.substr(end);
+    if (suffix == "K" || suffix == "k") {
+        value <<= 10;
+    } else if (suffix == "M" || suffix == "m") {
+        value <<= 20;
+    } else if (suffix == "G" || suffix == "g") {
+        value <<= 30;
+    } else if (!suffix.empty()) {
+        return false;
+    }
+
+    if (value <= 0) {
+        return false;
+    }
+    *size = value;
+    return true;
+}
+
+// Number of arrays of the chunk length used by the run formation
+int chunk_buffers(const ChunkEngine engine) {
+    if (engine == TIM_SORT_ENGINE) {
+        return 3; // Two chunks and the temporary array
+    }
+    if (engine == COUNTING_SORT_ENGINE) {
+        return 4; // Two chunks, the output array and the count array
+    }
+    return 2; // Two chunks
+}
+
+// Sort a chunk with the selected engine
+int *sort_chunk(const ChunkEngine engine, int *chunk, const int n, int *scratch) {
+    if (engine == TIM_SORT_ENGINE) {
+        sort_lib::RunStack run_stack;
+        sort_lib::tim_sort(chunk, n, scratch, &run_stack);
+        return chunk;
+    }
+
+    if (engine == COUNTING_SORT_ENGINE) {
+        const long long k = static_cast<long long>(sort_lib::find_max(n, chunk)) - sort_lib::find_min(n, chunk) + 1;
+        // The count array gets the second half of the scratch space
+        if (k <= n) {
+            int *count = scratch + n;
+            memset(count, 0, k * sizeof(int));
+            sort_lib::counting_sort(n, static_cast<int>(k), chunk, scratch, count);
+            return scratch;
+        }
+    }
+
+    // The ninther pivot keeps presorted chunks from reaching the heap sort of the introsort
+    sort_lib::intro_sort(chunk, 0, n, std::less<>(), sort_lib::LomutoPartition(), sort_lib::NintherPivot());
+    return chunk;
+}
+
+// Get a path for a new temporary run
+std::string temp_run_path(const std::string &temp_dir) {
+    // The prefix tells apart the runs of concurrent sorts sharing the directory
+    static const unsigned long long prefix = std::random_device()() * 0x100000001ULL + std::random_device()();
+    static int counter = 0;
+
+    std::ostringstream path;
+    path << temp_dir << "/external_sort_" << std::hex << prefix << std::dec << "_" << counter++ << ".run";
+    return path.str();
+}
+
+// Read, sort and spill the chunks of the input
+std::vector<std::string> create_runs(FILE *input, FILE *output, const ExternalSortConfig &config,
+                                     ExternalSortStats *stats) {
+    const int buffers = chunk_buffers(config.engine);
+    const int chunk_length = static_cast<int>(std::min(config.memory / static_cast<long long>(sizeof(int)) / buffers,
+                                                       static_cast<long long>(INT_MAX / 2)));
+    if (chunk_length < 1) {
+        throw std::runtime_error("The memory budget is too small");
+    }
+
+    std::vector<int> chunks[2] = {std::vector<int>(chunk_length), std::vector<int>(chunk_length)};
+    std::vector<int> scratch(static_cast<size_t>(buffers - 2) * chunk_length);
+    std::vector<std::string> runs;
+
+    try {
+        int current = 0;
+        auto length = static_cast<int>(fread(chunks[current].data(), sizeof(int), chunk_length, input));
+        while (length > 0) {
+            // Read the next chunk while the current one is sorted and spilled
+            std::future<size_t> next_read =
+                std::async(std::launch::async, [&chunks, current, chunk_length, input] {
+                    return fread(chunks[1 - current].data(), sizeof(int), chunk_length, input);
+                });
+
+            const int *sorted = sort_chunk(config.engine, chunks[current].data(), length, scratch.data());
+            stats->elements += length;
+
+            // The first chunk is the whole input if nothing follows it
+            int next_length = -1;
+            FILE *destination = output;
+            if (runs.empty()) {
+                next_length = static_cast<int>(next_read.get());
+            }
+            if (next_length != 0) {
+                runs.push_back(temp_run_path(config.temp_dir));
+                destination = fopen(runs.back().c_str(), "wb");
+                if (destination == nullptr) {
+                    throw std::runtime_error("Cannot create the temporary file " + runs.back());
+                }
+            }
+
+            const bool written = fwrite(sorted, sizeof(int), length, destination) == static_cast<size_t>(length);
+            if (destination != output && fclose(destination) != 0) {
+                throw std::runtime_error("Cannot write the temporary file " + runs.back());
+            }
+            if (!written) {
+                throw std::runtime_error("Cannot write the sorted chunk");
+            }
+
+            length = next_length >= 0 ? next_length : static_cast<int>(next_read.get());
+            current = 1 - current;
+        }
+
+        if (ferror(input)) {
+            throw std::runtime_error("Cannot read the input");
+        }
+    } catch (...) {
+        // The caller never gets the paths of the runs spilled so far, so they are removed here
+        for (const std::string &path: runs) {
+            std::remove(path.c_str());
+        }
+        throw;
+    }
+    stats->runs = static_cast<int>(runs.size());
+    return runs;
+}
+
+/**
+ * @brief Current key of a run during the merge
+ */
+struct MergeHead_t {
+    int key; // Current key of the run
+    int run; // Index of the run
+} typedef MergeHead;
+
+// Whether the head a goes after the head b in the heap, the run breaks the ties
+static bool head_after(const MergeHead &a, const MergeHead &b) {
+    return a.key > b.key || (a.key == b.key && a.run > b.run);
+}
+
+// Move the root of the heap down to its place
+static void sift_down_head(std::vector<MergeHead> &heap) {
+    const int size = static_cast<int>(heap.size());
+    const MergeHead head = heap[0];
+    int i = 0;
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && head_after(heap[child], heap[child + 1])) {
+            child++;
+        }
+        if (!head_after(head, heap[child])) {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = head;
+}
+
+// Merge sorted runs into the output
+void merge_runs(const std::vector<std::string> &runs, FILE *output, const int block_length) {
+    const int k = static_cast<int>(runs.size());
+    std::vector<FILE *> files(k, nullptr);
+    std::vector<std::unique_ptr<BlockReader>> readers(k);
+    std::vector<int> position(k, 0), length(k, 0);
+    std::vector<MergeHead> heap;
+
+    try {
+        for (int r = 0; r < k; r++) {
+            files[r] = fopen(runs[r].c_str(), "rb");
+            if (files[r] == nullptr) {
+                throw std::runtime_error("Cannot open the temporary file " + runs[r]);
+            }
+            readers[r] = std::make_unique<BlockReader>(files[r], block_length);
+            length[r] = readers[r]->next_block();
+            if (length[r] > 0) {
+                heap.push_back({readers[r]->data()[0], r});
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), head_after);
+
+        BlockWriter writer(output, block_length);
+        while (!heap.empty()) {
+            const int r = heap[0].run;
+            writer.push(heap[0].key);
+
+            // Replace the head by the next key of its run, or remove the run once it is exhausted
+            if (++position[r] == length[r]) {
+                length[r] = readers[r]->next_block();
+                position[r] = 0;
+            }
+            if (length[r] > 0) {
+                heap[0].key = readers[r]->data()[position[r]];
+            } else {
+                heap[0] = heap.back();
+                heap.pop_back();
+            }
+            if (!heap.empty()) {
+                sift_down_head(heap);
+            }
+        }
+        writer.close();
+    } catch (...) {
+        // The readers wait for their pending reads before their files are closed
+        readers.clear();
+        for (FILE *file: files) {
+            if (file != nullptr) {
+                fclose(file);
+            }
+        }
+        throw;
+    }
+
+    readers.clear();
+    for (FILE *file: files) {
+        fclose(file);
+    }
+}
+
+// Sort a file that may not fit in memory
+ExternalSortStats external_sort(const std::string &input_path, const std::string &output_path,
+                                const ExternalSortConfig &config) {
+    ExternalSortStats stats = {};
+
+    FILE *input = fopen(input_path.c_str(), "rb");
+    if (input == nullptr) {
+        throw std::runtime_error("Cannot open the input file " + input_path);
+    }
+    FILE *output = fopen(output_path.c_str(), "wb");
+    if (output == nullptr) {
+        fclose(input);
+        throw std::runtime_error("Cannot create the output file " + output_path);
+    }
+
+    // Cut the input into sorted runs
+    time_point_t start = std::chrono::steady_clock::now();
+    std::vector<std::string> runs;
+    try {
+        runs = create_runs(input, output, config, &stats);
+    } catch (...) {
+        fclose(input);
+        fclose(output);
+        throw;
+    }
+    fclose(input);
+    stats.run_time = std::chrono::duration_cast<time_unit_t>(std::chrono::steady_clock::now() - start).count();
+
+    // Every reader of the merge holds two blocks, and the writer two more
+    const long long budget_keys = config.memory / static_cast<long long>(sizeof(int));
+    long long block_length = config.block / static_cast<long long>(sizeof(int));
+    if (budget_keys / (2 * block_length) - 1 < 2) {
+        block_length = std::max(static_cast<long long>(EXTERNAL_MIN_BLOCK_LENGTH), budget_keys / 6);
+    }
+    block_length = std::min(block_length, static_cast<long long>(INT_MAX / 2));
+    const int max_fan_in = static_cast<int>(std::max(2LL, budget_keys / (2 * block_length) - 1));
+
+    start = std::chrono::steady_clock::now();
+    // Runs produced by the current merge pass, removed with the others if the pass fails
+    std::vector<std::string> merged;
+    try {
+        // Merge groups of runs into longer runs until a single merge can produce the output
+        while (static_cast<int>(runs.size()) > max_fan_in) {
+            for (size_t first = 0; first < runs.size(); first += max_fan_in) {
+                const size_t last = std::min(first + max_fan_in, runs.size());
+                const std::vector<std::string> group(runs.begin() + first, runs.begin() + last);
+
+                merged.push_back(temp_run_path(config.temp_dir));
+                FILE *run = fopen(merged.back().c_str(), "wb");
+                if (run == nullptr) {
+                    throw std::runtime_error("Cannot create the temporary file " + merged.back());
+                }
+                try {
+                    merge_runs(group, run, static_cast<int>(block_length));
+                } catch (...) {
+                    fclose(run);
+                    throw;
+                }
+                if (fclose(run) != 0) {
+                    throw std::runtime_error("Cannot write the temporary file " + merged.back());
+                }
+                for (const std::string &path: group) {
+                    std::remove(path.c_str());
+                }
+            }
+            runs.swap(merged);
+            merged.clear();
+            stats.merge_passes++;
+        }
+
+        if (!runs.empty()) {
+            merge_runs(runs, output, static_cast<int>(block_length));
+            stats.merge_passes++;
+        }
+    } catch (...) {
+        for (const std::string &path: runs) {
+            std::remove(path.c_str());
+        }
+        for (const std::string &path: merged) {
+            std::remove(path.c_str());
+        }
+        fclose(output);
+        throw;
+    }
+
+    for (const std::string &path: runs) {
+        std::remove(path.c_str());
+    }
+    if (fclose(output) != 0) {
+        throw std::runtime_error("Cannot write the output file " + output_path);
+    }
+    stats.merge_time = std::chrono::duration_cast<time_unit_t>(std::chrono::steady_clock::now() - start).count();
+
+    return stats;
+}
+
+// Write a file of random keys
+void generate_input_file(const std::string &path, const long long count, const int max) {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("Cannot create the file " + path);
+    }
+
+    // The keys are drawn directly, generate_input_data would put the maximum in every block
+    std::mt19937 &gen = get_input_generator();
+    std::uniform_int_distribution<> dis(0, max);
+
+    const int block_length = static_cast<int>(EXTERNAL_DEFAULT_BLOCK / sizeof(int));
+    std::vector<int> block(block_length);
+    bool written = true;
+    for (long long done = 0; done < count && written; done += block_length) {
+        const int length = static_cast<int>(std::min(static_cast<long long>(block_length), count - done));
+        for (int i = 0; i < length; i++) {
+            block[i] = dis(gen);
+        }
+        written = fwrite(block.data(), sizeof(int), length, file) == static_cast<size_t>(length);
+    }
+
+    if (fclose(file) != 0 || !written) {
+        throw std::runtime_error("Cannot write the file " + path);
+    }
+}
+
+// Check that a file of keys is sorted
+long long check_sorted_file(const std::string &path) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::runtime_error("Cannot open the file " + path);
+    }
+
+    long long count = 0;
+    bool sorted = true;
+    {
+        BlockReader reader(file, static_cast<int>(EXTERNAL_DEFAULT_BLOCK / sizeof(int)));
+        int previous = INT_MIN;
+        for (int length = reader.next_block(); length > 0 && sorted; length = reader.next_block()) {
+            for (int i = 0; i < length; i++) {
+                sorted &= reader.data()[i] >= previous;
+                previous = reader.data()[i];
+            }
+            count += length;
+        }
+    }
+    fclose(file);
+
+    if (!sorted) {
+        throw std::runtime_error("The file " + path + " is not sorted");
+    }
+    return count;
+}
+
+// Read the parameters of the sort from the options
+static bool read_config(const int argc, char *argv[], ExternalSortConfig *config) {
+    const std::string memory = get_option(argc, argv, "memory", std::to_string(EXTERNAL_DEFAULT_MEMORY));
+    if (!parse_size(memory, &config->memory)) {
+        std::cerr << "Invalid memory budget: " << memory << std::endl;
+        return false;
+    }
+    const std::string block = get_option(argc, argv, "block", std::to_string(EXTERNAL_DEFAULT_BLOCK));
+    if (!parse_size(block, &config->block)) {
+        std::cerr << "Invalid block size: " << block << std::endl;
+        return false;
+    }
+    const std::string engine = get_option(argc, argv, "engine", "tim_sort");
+    if (!parse_engine(engine, &config->engine)) {
+        std::cerr << "Unknown engine: " << engine << std::endl;
+        return false;
+    }
+    config->temp_dir = get_option(argc, argv, "temp-dir", ".");
+    return true;
+}
+
+// ------------------------ Main Function ------------------------
+
+#ifndef BENCHMARK_MODE
+
+int main(int argc, char *argv[]) {
+    ExternalSortConfig config;
+    if (!read_config(argc, argv, &config)) {
+        return 1;
+    }
+
+    // Read array from stdin
+    std::vector<int> data = read_input_data();
+
+    // Sort it through temporary files, with the memory budget of the options
+    const std::string input_path = temp_run_path(config.temp_dir) + ".in";
+    const std::string output_path = temp_run_path(config.temp_dir) + ".out";
+    try {
+        FILE *input = fopen(input_path.c_str(), "wb");
+        if (input == nullptr || fwrite(data.data(), sizeof(int), data.size(), input) != data.size() ||
+            fclose(input) != 0) {
+            throw std::runtime_error("Cannot write the file " + input_path);
+        }
+        external_sort(input_path, output_path, config);
+
+        FILE *output = fopen(output_path.c_str(), "rb");
+        if (output == nullptr || fread(data.data(), sizeof(int), data.size(), output) != data.size()) {
+            throw std::runtime_error("Cannot read the file " + output_path);
+        }
+        fclose(output);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        std::remove(input_path.c_str());
+        std::remove(output_path.c_str());
+        return 1;
+    }
+    std::remove(input_path.c_str());
+    std::remove(output_path.c_str());
+
+    // Print the sorted array
+    for (const int key: data) {
+        std::cout << key << " ";
+    }
+
+    return 0;
+}
+
+#else
+
+int main(const int argc, char *argv[]) {
+    const std::vector<std::string> args = get_positional_arguments(argc, argv);
+
+    if (args.size() < 4 || (args[1] != "sort" && args[1] != "generate")) {
+        std::cerr << "Usage: " << argv[0] << " sort [input_file] [output_file] [--memory=SIZE] [--block=SIZE]"
+                  << " [--engine=tim_sort|quick_sort|counting_sort] [--temp-dir=DIR] [--verify]" << std::endl
+                  << "       " << argv[0] << " generate [output_file] [count] [--max=N] [--seed=N]" << std::endl;
+        return 1;
+    }
+
+    try {
+        if (args[1] == "generate") {
+            // Generate the same keys as the other executables run with the same seed
+            const std::string seed = get_option(argc, argv, "seed", "");
+            if (!seed.empty()) {
+                set_input_seed(std::stoul(seed));
+            }
+            const long long count = std::stoll(args[3]);
+            generate_input_file(args[2], count, std::stoi(get_option(argc, argv, "max", std::to_string(INT_MAX))));
+            std::cout << "Generated " << count << " keys in " << args[2] << std::endl;
+            return 0;
+        }
+
+        ExternalSortConfig config;
+        if (!read_config(argc, argv, &config)) {
+            return 1;
+        }
+
+        const ExternalSortStats stats = external_sort(args[2], args[3], config);
+        const double seconds = static_cast<double>(stats.run_time + stats.merge_time) / 1e9;
+        std::cout << std::fixed << std::setprecision(3) << "Sorted " << stats.elements << " keys in " << seconds
+                  << " s (" << static_cast<double>(stats.elements) * sizeof(int) / (1 << 20) / seconds << " MB/s)"
+                  << std::endl
+                  << "Runs: " << stats.runs << ", run formation: " << static_cast<double>(stats.run_time) / 1e9
+                  << " s" << std::endl
+                  << "Merge passes: " << stats.merge_passes
+                  << ", merge: " << static_cast<double>(stats.merge_time) / 1e9 << " s" << std::endl;
+
+        if (has_flag(argc, argv, "verify")) {
+            const long long count = check_sorted_file(args[3]);
+            if (count != stats.elements) {
+                throw std::runtime_error("The output has " + std::to_string(count) + " keys instead of " +
+                                         std::to_string(stats.elements));
+            }
+            std::cout << "Verified: the output is sorted" << std::endl;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+#endif
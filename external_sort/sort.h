@@ -0,0 +1,258 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <cstdio>
+#include <future>
+#include <string>
+#include <vector>
+
+// Default memory budget of the buffers of the sort, in bytes.
+constexpr long long EXTERNAL_DEFAULT_MEMORY = 256LL << 20;
+// Default size of the blocks read and written by the merge, in bytes.
+constexpr long long EXTERNAL_DEFAULT_BLOCK = 1LL << 20;
+// The blocks of the merge are shrunk to fit the memory budget, down to this number of keys.
+constexpr int EXTERNAL_MIN_BLOCK_LENGTH = 256;
+
+/**
+ * @brief Algorithm of sort_lib used to sort the chunks that fit in memory
+ */
+enum ChunkEngine_t {
+    TIM_SORT_ENGINE, // sort_lib::tim_sort, with a temporary array of the chunk length
+    QUICK_SORT_ENGINE, // sort_lib::intro_sort, in place
+    COUNTING_SORT_ENGINE, // sort_lib::counting_sort, with an output array and a count array of the chunk length
+} typedef ChunkEngine;
+
+/**
+ * @brief Parameters of the external sort
+ */
+struct ExternalSortConfig_t {
+    long long memory; // Memory budget of the buffers of the sort, in bytes
+    long long block; // Size of the blocks read and written by the merge, in bytes
+    ChunkEngine engine; // Algorithm used to sort the chunks
+    std::string temp_dir; // Directory of the temporary files holding the sorted runs
+} typedef ExternalSortConfig;
+
+/**
+ * @brief Measurements of an external sort
+ */
+struct ExternalSortStats_t {
+    long long elements; // Number of keys sorted
+    int runs; // Number of sorted runs spilled to temporary files
+    int merge_passes; // Number of passes of the k-way merge over the data
+    long long run_time; // Time spent reading, sorting and spilling the chunks, in nanoseconds
+    long long merge_time; // Time spent merging the runs, in nanoseconds
+} typedef ExternalSortStats;
+
+/**
+ * @brief Reader of a file of int keys, one block at a time
+ *
+ * Double-buffered: while the caller consumes a block, the next one is read by an asynchronous task.
+ */
+class BlockReader {
+public:
+    /**
+     * @brief Start reading the first block of the file
+     * @param file The file, positioned at the first key to read
+     * @param block_length The number of keys of a block
+     */
+    BlockReader(FILE *file, int block_length);
+
+    /**
+     * @brief Wait for the pending read
+     */
+    ~BlockReader();
+
+    BlockReader(const BlockReader &) = delete;
+    BlockReader &operator=(const BlockReader &) = delete;
+
+    /**
+     * @brief Wait for the pending read, make its block current and start reading the following one
+     * @return The number of keys of the new current block, 0 at the end of the file
+     */
+    int next_block();
+
+    /**
+     * @brief Get the keys of the current block
+     * @return The keys, valid until the next call to next_block()
+     */
+    const int *data() const;
+
+private:
+    FILE *file; // File being read
+    std::vector<int> current; // Block returned to the caller
+    std::vector<int> next; // Block being read
+    std::future<size_t> pending; // Read of the next block
+};
+
+/**
+ * @brief Writer of a file of int keys, one block at a time
+ *
+ * Double-buffered: when a block is full it is written by an asynchronous task while the caller fills the other.
+ */
+class BlockWriter {
+public:
+    /**
+     * @brief Create the writer
+     * @param file The file, positioned where the keys are written
+     * @param block_length The number of keys of a block
+     */
+    BlockWriter(FILE *file, int block_length);
+
+    /**
+     * @brief Wait for the pending write
+     */
+    ~BlockWriter();
+
+    BlockWriter(const BlockWriter &) = delete;
+    BlockWriter &operator=(const BlockWriter &) = delete;
+
+    /**
+     * @brief Append a key to the current block, writing the block when it is full
+     * @param key The key
+     */
+    void push(int key) {
+        current[length++] = key;
+        if (length == static_cast<int>(current.size())) {
+            flush();
+        }
+    }
+
+    /**
+     * @brief Start writing the current block and wait for the previous write
+     * @throws std::runtime_error if a write fails
+     */
+    void flush();
+
+    /**
+     * @brief Write the current block and wait until every key is written
+     * @throws std::runtime_error if a write fails
+     */
+    void close();
+
+private:
+    FILE *file; // File being written
+    std::vector<int> current; // Block filled by the caller
+    std::vector<int> next; // Block being written
+    int length = 0; // Number of keys in the current block
+    std::future<bool> pending; // Write of the previous block, true on success
+};
+
+/**
+ * @brief Get the engine with the given name
+ * @param name "tim_sort", "quick_sort" or "counting_sort"
+ * @param engine The engine, set if the name is known
+ * @return true if the name is known
+ */
+bool parse_engine(const std::string &name, ChunkEngine *engine);
+
+/**
+ * @brief Parse a size in bytes with an optional K, M or G suffix (powers of 1024)
+ * @param text The size, e.g. "64K" or "2G"
+ * @param size The size in bytes, set if the text is valid
+ * @return true if the text is a positive size
+ */
+bool parse_size(const std::string &text, long long *size);
+
+/**
+ * @brief Get the number of chunks of the memory budget used by the run formation of an engine
+ *
+ * Two chunks hold the keys, so that the next chunk is read while the current one is sorted and spilled;
+ * tim_sort adds its temporary array and counting_sort its output and count arrays.
+ *
+ * @param engine The engine
+ * @return The number of arrays of the chunk length
+ */
+int chunk_buffers(ChunkEngine engine);
+
+/**
+ * @brief Sort a chunk with the selected engine
+ *
+ * counting_sort needs a count array of max - min + 1 ints: chunks whose key range does not fit in the scratch
+ * space are sorted with intro_sort instead.
+ *
+ * @param engine The engine
+ * @param chunk The keys to sort
+ * @param n The number of keys
+ * @param scratch The scratch space of the engine, (chunk_buffers(engine) - 2) * n ints
+ * @return The sorted keys: chunk, or scratch for counting_sort
+ */
+int *sort_chunk(ChunkEngine engine, int *chunk, int n, int *scratch);
+
+/**
+ * @brief Get a path for a new temporary file, unique among the processes sharing the directory
+ * @param temp_dir The directory of the temporary files
+ * @return The path, "<temp_dir>/external_sort_<random prefix>_<counter>.run"
+ */
+std::string temp_run_path(const std::string &temp_dir);
+
+/**
+ * @brief Read the input in chunks that fit the memory budget, sort them and spill them to temporary files
+ *
+ * The next chunk is read by an asynchronous task while the current one is sorted and written. When the whole
+ * input fits in one chunk, it is written directly to the output and no run is created.
+ *
+ * @param input The input file
+ * @param output The output file, only written when the input fits in one chunk
+ * @param config The parameters of the sort
+ * @param stats The measurements, elements and runs are set
+ * @return The paths of the runs
+ * @throws std::runtime_error if a temporary file cannot be written
+ */
+std::vector<std::string> create_runs(FILE *input, FILE *output, const ExternalSortConfig &config,
+                                     ExternalSortStats *stats);
+
+/**
+ * @brief Merge sorted runs into one sorted file with a k-way merge
+ *
+ * Every run is read with a BlockReader and the output is written with a BlockWriter; a binary heap of the
+ * current key of every run selects the next key.
+ *
+ * @param runs The paths of the runs
+ * @param output The output file
+ * @param block_length The number of keys of the blocks of the readers and the writer
+ * @throws std::runtime_error if a run cannot be read or the output cannot be written
+ */
+void merge_runs(const std::vector<std::string> &runs, FILE *output, int block_length);
+
+/**
+ * @brief Sort a file of native-endian 32-bit int keys that may not fit in memory
+ *
+ * The input is cut into sorted runs by create_runs. The runs are merged at most max_fan_in at a time, where
+ * max_fan_in is the number of double-buffered readers that fit in the memory budget: while there are more runs,
+ * groups of runs are merged into longer runs, then the last merge writes the output.
+ *
+ * @param input_path The path of the input file
+ * @param output_path The path of the output file, different from the input
+ * @param config The parameters of the sort
+ * @return The measurements of the sort
+ * @throws std::runtime_error if a file cannot be read or written
+ */
+ExternalSortStats external_sort(const std::string &input_path, const std::string &output_path,
+                                const ExternalSortConfig &config);
+
+/**
+ * @brief Write a file of random int keys, generated one block at a time
+ * @param path The path of the file
+ * @param count The number of keys
+ * @param max The maximum value of the keys
+ * @throws std::runtime_error if the file cannot be written
+ */
+void generate_input_file(const std::string &path, long long count, int max);
+
+/**
+ * @brief Check that a file of int keys is sorted
+ * @param path The path of the file
+ * @return The number of keys of the file
+ * @throws std::runtime_error if the file cannot be read or is not sorted
+ */
+long long check_sorted_file(const std::string &path);
+
+/**
+ * Main function to run the sort algorithm
+ * @param argc The number of command-line arguments
+ * @param argv The command-line arguments
+ * @return The exit status
+ */
+int main(int argc, char *argv[]);
+
+#endif
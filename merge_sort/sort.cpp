@@ -0,0 +1,223 @@
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "merge_sort.h"
+#include "sort.h"
+#include "utils.h"
+
+// ------------------------ Algorithm Code ------------------------
+
+// Function to get the number of runs merged at once from its option
+bool parse_ways(const std::string &name, int *ways) {
+    if (name == "2" || name == "4" || name == "8") {
+        *ways = std::stoi(name);
+        return true;
+    }
+    return false;
+}
+
+// Stable merge sort function, the passes alternate between arr and temp_arr
+void merge_sort(int *arr, const int n, int *temp_arr, const int ways) {
+    sort_lib::merge_sort(arr, n, temp_arr, std::less<>(), ways);
+}
+
+// ------------------------ Benchmarking Code ------------------------
+
+long long benchmark_algorithm(const int n, int data[], BenchmarkArena *arena, const int ways) {
+    // Reuse the buffers of the arena to avoid the overhead of malloc
+    const int ring_size = copy_ring_size(n * sizeof(int));
+    auto *data_copy = arena->get<int>(COPY_BUFFER, static_cast<long long>(ring_size) * n);
+    auto *temp_arr = arena->get<int>(TEMP_BUFFER, n);
+
+    return measure_algorithm(
+            ring_size,
+            [&](const int k) {
+                // Duplicate the input data
+                memcpy(data_copy + static_cast<long long>(k) * n, data, n * sizeof(int));
+            },
+            [&](const int k) {
+                // Call the sort function
+                merge_sort(data_copy + static_cast<long long>(k) * n, n, temp_arr, ways);
+            });
+}
+
+// ------------------------ Main Function ------------------------
+
+#ifndef BENCHMARK_MODE
+
+int main(int argc, char *argv[]) {
+    // Select the number of runs merged at once
+    int ways;
+    if (!parse_ways(get_option(argc, argv, "ways", "2"), &ways)) {
+        std::cerr << "Unknown number of ways: " << get_option(argc, argv, "ways", "2") << std::endl;
+        return 1;
+    }
+
+    // Read array from stdin
+    std::vector<int> data = read_input_data();
+
+    // Convert the vector to an array
+    const int n = data.size();
+    int *arr = data.data();
+
+    // Execute the sort algorithm
+    std::vector<int> temp(n);
+    merge_sort(arr, n, temp.data(), ways);
+
+    // Print the sorted array
+    for (int i = 0; i < n; i++) {
+        std::cout << arr[i] << " ";
+    }
+
+    return 0;
+}
+
+#else
+
+int main(const int argc, char *argv[]) {
+    set_cpu_affinity();
+
+    const std::vector<std::string> args = get_positional_arguments(argc, argv);
+
+    if (args.size() < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [length|max] [linear|exponential] [output_file] [--ways=2|4|8] [--max-length=N]"
+                     " [--order=random|sorted|reversed|organ_pipe|nearly_sorted|shuffled_runs] [--seed=N]"
+                     " [--huge-pages] [--counters] [--timing=total|sort] [--cores=LIST]"
+                  << std::endl;
+        return 1;
+    }
+
+    // Select the number of runs merged at once
+    const std::string ways_name = get_option(argc, argv, "ways", "2");
+    int ways;
+    if (!parse_ways(ways_name, &ways)) {
+        std::cerr << "Unknown number of ways: " << ways_name << std::endl;
+        return 1;
+    }
+
+    // Select the order of the input data
+    const std::string order = get_option(argc, argv, "order", "random");
+    if (!is_valid_input_order(order)) {
+        std::cerr << "Unknown input order: " << order << std::endl;
+        return 1;
+    }
+
+    // Generate the same input data as the other executables run with the same seed
+    const std::string seed = get_option(argc, argv, "seed", "");
+    if (!seed.empty()) {
+        set_input_seed(std::stoul(seed));
+    }
+
+    const std::string mode = args[1];
+    const bool test_length = (mode == "length");
+
+    // Default to exponential scaling if not specified
+    bool linear_scaling = false;
+    if (args.size() >= 3) {
+        const std::string scaling_mode = args[2];
+        linear_scaling = (scaling_mode == "linear");
+    }
+
+    // Output filename
+    std::string output_file;
+    if (args.size() >= 4) {
+        output_file = args[3];
+    } else {
+        // Generate a filename based on test parameters and timestamp
+        std::string sort_type = "merge_sort_" + ways_name + "way";
+        if (order != "random") {
+            sort_type += "_" + order;
+        }
+        output_file = generate_filename(test_length ? "length" : "max", linear_scaling, sort_type);
+    }
+
+    std::vector<RunResult> runs;
+
+    // Determine which parameter to vary and its range
+    int min_param, max_param;
+    bool vary_length;
+    if (test_length) {
+        min_param = 100; // min_length
+        max_param = std::stoi(get_option(argc, argv, "max-length", "100000")); // max_length
+        vary_length = true;
+    } else {
+        min_param = 10; // min_max
+        max_param = 1000000; // max_max
+        vary_length = false;
+    }
+
+    // Generate sample points based on scaling type
+    std::vector<int> sample_points = generate_sample_points(min_param, max_param, NUM_SAMPLES, linear_scaling);
+
+    // Allocate the buffers once for the largest arrays of the sweep
+    BenchmarkArena arena((vary_length ? max_param : 100000) * sizeof(int), has_flag(argc, argv, "huge-pages"));
+
+    // Count the hardware events of the timed loops if requested
+    if (has_flag(argc, argv, "counters")) {
+        enable_perf_counters();
+    }
+
+    // Select whether the timed loops measure the copies of the input or only the sorts
+    const std::string timing = get_option(argc, argv, "timing", "total");
+    TimingMode timing_mode;
+    if (!parse_timing_mode(timing, &timing_mode)) {
+        std::cerr << "Unknown timing mode: " << timing << std::endl;
+        return 1;
+    }
+    set_timing_mode(timing_mode);
+
+    // Shard the sample points across worker processes pinned to the given cores, if any
+    const std::string cores_option = get_option(argc, argv, "cores", "");
+    std::vector<int> cores;
+    if (!parse_core_list(cores_option, &cores)) {
+        std::cerr << "Invalid list of cores: " << cores_option << std::endl;
+        return 1;
+    }
+
+    // Run tests for each sample point, sharded across the cores if requested
+    const bool completed = run_sweep(sample_points, cores, &runs, [&](const int param_value) {
+        RunResult run = {};
+
+        if (vary_length) {
+            run.max = 1000000;
+            run.length = param_value;
+        } else {
+            run.max = param_value;
+            run.length = 100000;
+        }
+
+        // Run multiple times for each sample point
+        for (int r = 0; r < NUM_RUNS; r++) {
+            // Generate input data with appropriate parameters
+            const auto data = arena.get<int>(INPUT_BUFFER, run.length);
+            generate_input_data(data, run.length, run.min, run.max);
+            arrange_input_data(data, run.length, order);
+            // Execute and record time
+            run.time[r] = benchmark_algorithm(run.length, data, &arena, ways);
+            add_perf_counters(&run);
+            add_copy_time(&run);
+        }
+
+        // Print results for this run
+        std::cout << "Length: " << run.length << ", Min: " << run.min << ", Max: " << run.max << std::endl;
+
+        return run;
+    });
+    if (!completed) {
+        return 1;
+    }
+
+    // Write results to CSV file
+    write_results_to_csv(output_file, runs);
+
+    return 0;
+}
+
+#endif
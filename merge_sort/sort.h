@@ -0,0 +1,43 @@
+#ifndef MERGE_SORT_H
+#define MERGE_SORT_H
+
+#include <string>
+
+#include "arena.h"
+
+/**
+ * @brief Get the number of runs merged at once from its option
+ * @param name "2", "4" or "8"
+ * @param ways The number of runs, set if the name is valid
+ * @return true if the name is valid
+ */
+bool parse_ways(const std::string &name, int *ways);
+
+/**
+ * Stable merge sort function to sort the array (sort_lib::merge_sort on int)
+ * @param arr The array of integers
+ * @param n The length of the array
+ * @param temp_arr The temporary array, of length n
+ * @param ways The number of runs merged at once: 2, 4 or 8
+ */
+void merge_sort(int *arr, int n, int *temp_arr, int ways = 2);
+
+/**
+ * Execute the sort algorithm
+ * @param n The length of the array
+ * @param data The array of integers
+ * @param arena The buffers of the benchmark
+ * @param ways The number of runs merged at once
+ * @return The execution time in nanoseconds
+ */
+long long benchmark_algorithm(int n, int data[], BenchmarkArena *arena, int ways = 2);
+
+/**
+ * Main function to run the sort algorithm
+ * @param argc The number of command-line arguments
+ * @param argv The command-line arguments
+ * @return The exit status
+ */
+int main(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,353 @@
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "partition.h"
+#include "sort.h"
+#include "sorting_network.h"
+#include "utils.h"
+
+// ------------------------ Algorithm Code ------------------------
+
+// Order three elements of the array
+void sort3(int *a, const int x, const int y, const int z) {
+    if (a[y] < a[x]) {
+        swap(a, x, y);
+    }
+    if (a[z] < a[y]) {
+        swap(a, y, z);
+        if (a[y] < a[x]) {
+            swap(a, x, y);
+        }
+    }
+}
+
+// Choose the pivot and move it to the last position
+void choose_pivot(int *a, const int i, const int j) {
+    const int n = j - i;
+    const int mid = i + n / 2;
+
+    if (n > PDQ_NINTHER_THRESHOLD) {
+        // Tukey's ninther: median of the medians of three groups of 3 elements
+        sort3(a, i, mid, j - 1);
+        sort3(a, i + 1, mid - 1, j - 2);
+        sort3(a, i + 2, mid + 1, j - 3);
+        sort3(a, mid - 1, mid, mid + 1);
+    } else {
+        // Median of 3
+        sort3(a, i, mid, j - 1);
+    }
+
+    swap(a, mid, j - 1);
+}
+
+// Insertion sort that gives up when the subarray is not almost sorted
+bool partial_insertion_sort(int *a, const int i, const int j) {
+    int moved = 0; // Number of elements moved so far
+    for (int m = i + 1; m < j; m++) {
+        const int temp = a[m];
+        int l = m - 1;
+        while (l >= i && a[l] > temp) {
+            a[l + 1] = a[l];
+            l--;
+        }
+        a[l + 1] = temp;
+
+        moved += m - 1 - l;
+        if (moved > PARTIAL_INSERTION_SORT_LIMIT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Partition function that detects already partitioned subarrays
+int pdq_partition(int *a, const int i, const int j, bool *already_partitioned) {
+    const int pivot = a[j - 1]; // The pivot has been moved to the last position by choose_pivot
+
+    // Skip the elements already on the correct side
+    int l = i;
+    while (l < j - 1 && a[l] <= pivot) {
+        l++;
+    }
+    int r = j - 2;
+    while (r >= l && a[r] > pivot) {
+        r--;
+    }
+
+    // No misplaced element found: put the pivot between the two partitions
+    *already_partitioned = r < l;
+    if (*already_partitioned) {
+        swap(a, l, j - 1);
+        return l;
+    }
+
+    // Elements in [i, l) are <= pivot and elements in (r, j - 1) are > pivot:
+    // move the pivot right after a[r] and partition only a[l:r + 2]
+    swap(a, r + 1, j - 1);
+    return block_partition(a, l, r + 2);
+}
+
+// Main loop of the pattern-defeating QuickSort
+void pdq_sort_loop(int *a, int i, int j, int bad_allowed, bool rightmost) {
+    while (true) {
+        const int n = j - i;
+
+        // Base case: small subarray
+        if (n <= sort_lib::SMALL_SORT_THRESHOLD) {
+            sort_lib::network_sort(a, i, j, std::less<>());
+            return;
+        }
+        if (n <= PDQ_INSERTION_THRESHOLD) {
+            insertion_sort(a, i, j - 1);
+            return;
+        }
+
+        choose_pivot(a, i, j);
+
+        // a[j] is greater than or equal to every element of the subarray: if it is equal to the pivot,
+        // the subarray contains no element greater than the pivot and likely many copies of it
+        if (!rightmost && a[j] == a[j - 1]) {
+            int k, l;
+            partition_3way(a, i, j, &k, &l);
+            j = k; // Elements in [k, j) are equal to the pivot
+            continue;
+        }
+
+        bool already_partitioned;
+        const int k = pdq_partition(a, i, j, &already_partitioned);
+        const int left = k - i; // Length of the left partition
+        const int right = j - k - 1; // Length of the right partition
+
+        if (left < n / 8 || right < n / 8) {
+            // Highly unbalanced partition: too many of them lead to heap sort
+            if (--bad_allowed == 0) {
+                heap_sort(a, i, j);
+                return;
+            }
+
+            // Swap some elements to break the pattern that caused the unbalanced partition
+            if (left >= PDQ_INSERTION_THRESHOLD) {
+                swap(a, i, i + left / 4);
+                swap(a, k - 1, k - left / 4);
+                if (left > PDQ_NINTHER_THRESHOLD) {
+                    swap(a, i + 1, i + left / 4 + 1);
+                    swap(a, i + 2, i + left / 4 + 2);
+                    swap(a, k - 2, k - left / 4 - 1);
+                    swap(a, k - 3, k - left / 4 - 2);
+                }
+            }
+            if (right >= PDQ_INSERTION_THRESHOLD) {
+                swap(a, k + 1, k + 1 + right / 4);
+                swap(a, j - 1, j - right / 4);
+                if (right > PDQ_NINTHER_THRESHOLD) {
+                    swap(a, k + 2, k + 2 + right / 4);
+                    swap(a, k + 3, k + 3 + right / 4);
+                    swap(a, j - 2, j - 1 - right / 4);
+                    swap(a, j - 3, j - 2 - right / 4);
+                }
+            }
+        } else if (already_partitioned && partial_insertion_sort(a, i, k) && partial_insertion_sort(a, k + 1, j)) {
+            // Balanced partition without moved elements: both sides were already sorted
+            return;
+        }
+
+        // Sort the left partition recursively, whose successor is the pivot, and loop on the right one
+        pdq_sort_loop(a, i, k, bad_allowed, false);
+        i = k + 1;
+    }
+}
+
+// Pattern-defeating QuickSort function to sort the subarray a[i:j] (j exclusive)
+void pdq_sort(int *a, const int i, const int j) {
+    // Allow floor(log2(n)) unbalanced partitions before switching to heap sort
+    int bad_allowed = 0;
+    for (int n = j - i; n > 1; n >>= 1) {
+        bad_allowed++;
+    }
+
+    pdq_sort_loop(a, i, j, bad_allowed, true);
+}
+
+// ------------------------ Benchmarking Code ------------------------
+
+long long benchmark_algorithm(const int n, int data[], BenchmarkArena *arena) {
+    // Reuse the buffers of the arena to avoid the overhead of malloc
+    const int ring_size = copy_ring_size(n * sizeof(int));
+    auto *data_copy = arena->get<int>(COPY_BUFFER, static_cast<long long>(ring_size) * n);
+
+    return measure_algorithm(
+            ring_size,
+            [&](const int k) {
+                // Duplicate the input data
+                memcpy(data_copy + static_cast<long long>(k) * n, data, n * sizeof(int));
+            },
+            [&](const int k) {
+                // Call the sort function
+                pdq_sort(data_copy + static_cast<long long>(k) * n, 0, n);
+            });
+}
+
+// ------------------------ Main Function ------------------------
+
+#ifndef BENCHMARK_MODE
+
+int main(int argc, char *argv[]) {
+    // Read array from stdin
+    std::vector<int> data = read_input_data();
+
+    // Convert the vector to an array
+    const int n = data.size();
+    int *arr = data.data();
+
+    // Execute the sort algorithm
+    pdq_sort(arr, 0, n);
+
+    // Print the sorted array
+    for (int i = 0; i < n; i++) {
+        std::cout << arr[i] << " ";
+    }
+
+    return 0;
+}
+
+#else
+
+int main(const int argc, char *argv[]) {
+    set_cpu_affinity();
+
+    const std::vector<std::string> args = get_positional_arguments(argc, argv);
+
+    if (args.size() < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [length|max] [linear|exponential] [output_file]"
+                     " [--order=random|sorted|reversed|organ_pipe|nearly_sorted|shuffled_runs] [--seed=N]"
+                     " [--huge-pages] [--counters] [--timing=total|sort] [--cores=LIST]"
+                  << std::endl;
+        return 1;
+    }
+
+    // Select the order of the input data
+    const std::string order = get_option(argc, argv, "order", "random");
+    if (!is_valid_input_order(order)) {
+        std::cerr << "Unknown input order: " << order << std::endl;
+        return 1;
+    }
+
+    // Generate the same input data as the other executables run with the same seed
+    const std::string seed = get_option(argc, argv, "seed", "");
+    if (!seed.empty()) {
+        set_input_seed(std::stoul(seed));
+    }
+
+    const std::string mode = args[1];
+    const bool test_length = (mode == "length");
+
+    // Default to exponential scaling if not specified
+    bool linear_scaling = false;
+    if (args.size() >= 3) {
+        const std::string scaling_mode = args[2];
+        linear_scaling = (scaling_mode == "linear");
+    }
+
+    // Output filename
+    std::string output_file;
+    if (args.size() >= 4) {
+        output_file = args[3];
+    } else {
+        // Generate a filename based on test parameters and timestamp
+        std::string sort_type = "pdq_sort";
+        if (order != "random") {
+            sort_type += "_" + order;
+        }
+        output_file = generate_filename(test_length ? "length" : "max", linear_scaling, sort_type);
+    }
+
+    std::vector<RunResult> runs;
+
+    // Determine which parameter to vary and its range
+    int min_param, max_param;
+    bool vary_length;
+    if (test_length) {
+        min_param = 100; // min_length
+        max_param = 100000; // max_length
+        vary_length = true;
+    } else {
+        min_param = 10; // min_max
+        max_param = 1000000; // max_max
+        vary_length = false;
+    }
+
+    // Generate sample points based on scaling type
+    std::vector<int> sample_points = generate_sample_points(min_param, max_param, NUM_SAMPLES, linear_scaling);
+
+    // Allocate the buffers once for the largest arrays of the sweep
+    BenchmarkArena arena((vary_length ? max_param : 100000) * sizeof(int), has_flag(argc, argv, "huge-pages"));
+
+    // Count the hardware events of the timed loops if requested
+    if (has_flag(argc, argv, "counters")) {
+        enable_perf_counters();
+    }
+
+    // Select whether the timed loops measure the copies of the input or only the sorts
+    const std::string timing = get_option(argc, argv, "timing", "total");
+    TimingMode timing_mode;
+    if (!parse_timing_mode(timing, &timing_mode)) {
+        std::cerr << "Unknown timing mode: " << timing << std::endl;
+        return 1;
+    }
+    set_timing_mode(timing_mode);
+
+    // Shard the sample points across worker processes pinned to the given cores, if any
+    const std::string cores_option = get_option(argc, argv, "cores", "");
+    std::vector<int> cores;
+    if (!parse_core_list(cores_option, &cores)) {
+        std::cerr << "Invalid list of cores: " << cores_option << std::endl;
+        return 1;
+    }
+
+    // Run tests for each sample point, sharded across the cores if requested
+    const bool completed = run_sweep(sample_points, cores, &runs, [&](const int param_value) {
+        RunResult run = {};
+
+        if (vary_length) {
+            run.max = 1000000;
+            run.length = param_value;
+        } else {
+            run.max = param_value;
+            run.length = 100000;
+        }
+
+        // Run multiple times for each sample point
+        for (int r = 0; r < NUM_RUNS; r++) {
+            // Generate input data with appropriate parameters
+            const auto data = arena.get<int>(INPUT_BUFFER, run.length);
+            generate_input_data(data, run.length, run.min, run.max);
+            arrange_input_data(data, run.length, order);
+            // Execute and record time
+            run.time[r] = benchmark_algorithm(run.length, data, &arena);
+            add_perf_counters(&run);
+            add_copy_time(&run);
+        }
+
+        // Print results for this run
+        std::cout << "Length: " << run.length << ", Min: " << run.min << ", Max: " << run.max << std::endl;
+
+        return run;
+    });
+    if (!completed) {
+        return 1;
+    }
+
+    // Write results to CSV file
+    write_results_to_csv(output_file, runs);
+
+    return 0;
+}
+
+#endif
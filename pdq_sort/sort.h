@@ -0,0 +1,107 @@
+#ifndef PDQ_SORT_H
+#define PDQ_SORT_H
+
+#include "arena.h"
+
+// Subarrays up to this length are sorted with insertion sort, or with sort_lib::network_sort when they are not
+// longer than sort_lib::SMALL_SORT_THRESHOLD.
+constexpr int PDQ_INSERTION_THRESHOLD = 24;
+// Subarrays longer than this choose the pivot with Tukey's ninther instead of the median of 3.
+constexpr int PDQ_NINTHER_THRESHOLD = 128;
+// Maximum number of elements moved by partial_insertion_sort before it gives up.
+constexpr int PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+/**
+ * @brief Order three elements of the array
+ *
+ * After the call a[x] <= a[y] <= a[z].
+ *
+ * @param a The array of integers
+ * @param x The index of the first element
+ * @param y The index of the second element
+ * @param z The index of the third element
+ */
+void sort3(int *a, int x, int y, int z);
+
+/**
+ * @brief Choose the pivot of the subarray and move it to the last position
+ *
+ * The pivot is the median of the first, middle and last element, or Tukey's ninther (the median of three
+ * medians of 3) for subarrays longer than PDQ_NINTHER_THRESHOLD.
+ *
+ * @param a The array of integers
+ * @param i The index of the first element
+ * @param j The index of the last element (exclusive)
+ */
+void choose_pivot(int *a, int i, int j);
+
+/**
+ * @brief Try to sort the subarray with insertion sort, giving up if it is not almost sorted
+ * @param a The array of integers
+ * @param i The index of the first element
+ * @param j The index of the last element (exclusive)
+ * @return true if the subarray has been sorted, false if more than PARTIAL_INSERTION_SORT_LIMIT elements
+ * had to be moved
+ */
+bool partial_insertion_sort(int *a, int i, int j);
+
+/**
+ * @brief Partitions the array around its last element, detecting already partitioned subarrays
+ *
+ * The elements already in place at both ends are skipped first, then the rest is partitioned with
+ * block_partition. The result is the same as the Lomuto partition: elements less than or equal to the pivot
+ * are placed on its left.
+ *
+ * @param a The array of integers
+ * @param i The index of the first element
+ * @param j The index of the last element (exclusive)
+ * @param already_partitioned Set to true if no element had to be moved
+ * @return The final index position of the pivot after partitioning.
+ */
+int pdq_partition(int *a, int i, int j, bool *already_partitioned);
+
+/**
+ * @brief Main loop of the pattern-defeating quicksort
+ *
+ * - When the pivot is equal to the element right after the subarray, which is greater than or equal to all
+ *   its elements, the subarray contains many equal keys: it is split with partition_3way and the elements
+ *   equal to the pivot are not sorted again.
+ * - When a partition is highly unbalanced, some elements are swapped to break the pattern of the input; after
+ *   log2(n) bad partitions the subarray is sorted with heap_sort.
+ * - When a partition is balanced and no element had to be moved, both sides are likely sorted and
+ *   partial_insertion_sort is tried on them.
+ *
+ * @param a The array of integers
+ * @param i The index of the first element
+ * @param j The index of the last element (exclusive)
+ * @param bad_allowed The number of unbalanced partitions left before switching to heap sort
+ * @param rightmost true if the subarray is at the end of the array, so a[j] does not exist
+ */
+void pdq_sort_loop(int *a, int i, int j, int bad_allowed, bool rightmost);
+
+/**
+ * Pattern-defeating QuickSort function to sort the subarray a[i:j] (j exclusive)
+ * @param a The array of integers
+ * @param i The index of the first element
+ * @param j The index of the last element (exclusive)
+ */
+void pdq_sort(int *a, int i, int j);
+
+/**
+ * Execute the sort algorithm
+ * @param n The length of the array
+ * @param data The array of integers
+ * @param arena The buffers of the benchmark
+ * @return The execution time in nanoseconds
+ */
+long long benchmark_algorithm(int n, int data[], BenchmarkArena *arena);
+
+/**
+ * Main function to run the sort algorithm
+ * @param argc The number of command-line arguments
+ * @param argv The command-line arguments
+ * @return The exit status
+ */
+int main(int argc, char *argv[]);
+
+#endif
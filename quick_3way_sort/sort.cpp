@@ -3,99 +3,64 @@
 #include <cmath>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#include "quick_3way_sort.h"
 #include "sort.h"
 #include "utils.h"
 
 // ------------------------ Algorithm Code ------------------------
 
-// Partition function
-void partition_3way(int *a, const int i, const int j, int *k, int *l) {
-    // The function partitions the array into three parts:
-    // - Elements less than the pivot
-    // - Elements equal to the pivot
-    // - Elements greater than the pivot
-
-    const int pivot = a[j - 1]; // Choose the last element as the pivot
-    int p1 = i, p2 = i, p3 = i;
-
-    while (p3 < j) {
-        if (a[p3] < pivot) { // Case 1: Current element is less than the pivot
-            swap(a, p3, p2); // Move current element to the <= pivot region
-            swap(a, p2, p1); // Move boundary for < pivot
-            p1++;
-            p2++;
-            p3++;
-        } else if (a[p3] == pivot) { // Case 2: Current element is equal to the pivot
-            swap(a, p3, p2); // Move current element to the <= pivot region
-            p2++;
-            p3++;
-        } else { // Case 3: Current element is greater than the pivot
-            p3++; // Simply move to the next element
-        }
-    }
-
-    // After the loop:
-    // - Elements in range [i, p1) are < pivot
-    // - Elements in range [p1, p2) are == pivot
-    // - Elements in range [p2, j) are > pivot
+// Recursive 3-way QuickSort function
+void quick_3way_sort(int *a, const int i, const int j, const Partition3WayFunction partition_fn,
+                     const PivotPolicy pivot) {
+    with_pivot_policy(pivot, [=](auto pivot_fn) {
+        sort_lib::quick_3way_sort(a, i, j, std::less<>(), Partition3WayCaller{partition_fn}, pivot_fn);
+    });
+}
 
-    *k = p1; // Set `k` to the start of the == pivot region
-    *l = p2; // Set `l` to the end of the == pivot region
+// Dual-pivot QuickSort function
+void dual_pivot_quick_sort(int *a, const int i, const int j, Partition3WayFunction, PivotPolicy) {
+    sort_lib::dual_pivot_quick_sort(a, i, j, std::less<>());
 }
 
-// Recursive 3-way QuickSort function
-void quick_3way_sort(int *a, const int i, const int j) {
-    if (j - i <= 1) {
-        // Base case: If the subarray size is 0 or 1, it is already sorted
-        return;
+// Function to get a 3-way partition function by name
+Partition3WayFunction get_partition_3way_function(const std::string &name) {
+    if (name == "dutch") {
+        return partition_3way;
     }
-
-    int k, l;
-    // Partition the array into three parts
-    partition_3way(a, i, j, &k, &l);
-
-    quick_3way_sort(a, i, k); // Recursively sort the < pivot region
-    quick_3way_sort(a, l, j); // Recursively sort the > pivot region
+    if (name == "simd") {
+        return simd_partition_3way;
+    }
+    if (name == "bentley_mcilroy") {
+        return bentley_mcilroy_partition_3way;
+    }
+    return nullptr;
 }
 
 // ------------------------ Benchmarking Code ------------------------
 
-long long benchmark_algorithm(const int n, int data[]) {
-    // Pre allocate the memory to avoid the overhead of malloc
-    auto *data_copy = new int[n];
-
-    // Get the resolution of the clock
-    const auto min_time = get_minimum_time();
-
-    // Initialize the clock to measure the execution time
-    long long elapsed = 0;
-    // Measure the elapsed time
-    int i = 0; // Counter to measure the number of iterations
-    const time_point_t start = std::chrono::steady_clock::now(); // Start the clock
-    while (elapsed < min_time) { // Continue until the minimum time is reached
-        // Increment the counter
-        i++;
-
-        // Duplicate the input data
-        memcpy(data_copy, data, n * sizeof(int));
-
-        // Call the sort function
-        quick_3way_sort(data, 0, n);
-        // Measure the elapsed time
-        time_point_t end = std::chrono::steady_clock::now();
-        elapsed = std::chrono::duration_cast<time_unit_t>(end - start).count();
-    }
-
-    // Free the allocated memory
-    delete[] data_copy;
-
-    // Compute the elapsed time in nanoseconds
-    return elapsed / i;
+long long benchmark_algorithm(const int n, int data[], BenchmarkArena *arena,
+                              const Partition3WayFunction partition_fn, const PivotPolicy pivot,
+                              const SortFunction sort_fn) {
+    // Reuse the buffers of the arena to avoid the overhead of malloc
+    const int ring_size = copy_ring_size(n * sizeof(int));
+    auto *data_copy = arena->get<int>(COPY_BUFFER, static_cast<long long>(ring_size) * n);
+
+    return measure_algorithm(
+            ring_size,
+            [&](const int k) {
+                // Duplicate the input data
+                memcpy(data_copy + static_cast<long long>(k) * n, data, n * sizeof(int));
+            },
+            [&](const int k) {
+                // Call the sort function
+                sort_fn(data_copy + static_cast<long long>(k) * n, 0, n, partition_fn, pivot);
+            });
 }
 
 // ------------------------ Main Function ------------------------
@@ -110,8 +75,39 @@ int main(int argc, char *argv[]) {
     const int n = data.size();
     int *arr = data.data();
 
+    // Select the partition function
+    const std::string kernel = get_option(argc, argv, "partition", "dutch");
+    const Partition3WayFunction partition_fn = get_partition_3way_function(kernel);
+    if (partition_fn == nullptr) {
+        std::cerr << "Unknown partition function: " << kernel << std::endl;
+        return 1;
+    }
+
+    // Select the pivot policy
+    const std::string pivot_name = get_option(argc, argv, "pivot", "last");
+    PivotPolicy pivot;
+    if (!parse_pivot_policy(pivot_name, &pivot)) {
+        std::cerr << "Unknown pivot policy: " << pivot_name << std::endl;
+        return 1;
+    }
+
+    // Select the sort function
+    const std::string variant = get_option(argc, argv, "variant", "3way");
+    if (variant != "3way" && variant != "dual_pivot") {
+        std::cerr << "Unknown variant: " << variant << std::endl;
+        return 1;
+    }
+    if (variant == "dual_pivot" && (kernel != "dutch" || pivot != LAST_PIVOT)) {
+        std::cerr << "The dual_pivot variant has no --partition and --pivot options" << std::endl;
+        return 1;
+    }
+
     // Execute the sort algorithm
-    quick_3way_sort(arr, 0, n);
+    if (variant == "dual_pivot") {
+        dual_pivot_quick_sort(arr, 0, n);
+    } else {
+        quick_3way_sort(arr, 0, n, partition_fn, pivot);
+    }
 
     // Print the sorted array
     for (int i = 0; i < n; i++) {
@@ -126,28 +122,88 @@ int main(int argc, char *argv[]) {
 int main(const int argc, char *argv[]) {
     set_cpu_affinity();
 
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " [length|max] [linear|exponential] [output_file]" << std::endl;
+    const std::vector<std::string> args = get_positional_arguments(argc, argv);
+
+    if (args.size() < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [length|max] [linear|exponential] [output_file] [--max-length=N]"
+                     " [--partition=dutch|simd|bentley_mcilroy]"
+                     " [--variant=3way|dual_pivot]"
+                     " [--pivot=last|random|median3|ninther|median_of_medians]"
+                     " [--order=random|sorted|reversed|organ_pipe|nearly_sorted|shuffled_runs] [--seed=N]"
+                     " [--huge-pages] [--counters] [--timing=total|sort] [--cores=LIST]"
+                  << std::endl;
         return 1;
     }
 
-    const std::string mode = argv[1];
+    // Select the order of the input data
+    const std::string order = get_option(argc, argv, "order", "random");
+    if (!is_valid_input_order(order)) {
+        std::cerr << "Unknown input order: " << order << std::endl;
+        return 1;
+    }
+
+    // Generate the same input data as the other executables run with the same seed
+    const std::string seed = get_option(argc, argv, "seed", "");
+    if (!seed.empty()) {
+        set_input_seed(std::stoul(seed));
+    }
+
+    // Select the partition function
+    const std::string kernel = get_option(argc, argv, "partition", "dutch");
+    const Partition3WayFunction partition_fn = get_partition_3way_function(kernel);
+    if (partition_fn == nullptr) {
+        std::cerr << "Unknown partition function: " << kernel << std::endl;
+        return 1;
+    }
+
+    // Select the pivot policy
+    const std::string pivot_name = get_option(argc, argv, "pivot", "last");
+    PivotPolicy pivot;
+    if (!parse_pivot_policy(pivot_name, &pivot)) {
+        std::cerr << "Unknown pivot policy: " << pivot_name << std::endl;
+        return 1;
+    }
+
+    // Select the sort function: the dual-pivot sort has its own partition and pivots
+    const std::string variant = get_option(argc, argv, "variant", "3way");
+    if (variant != "3way" && variant != "dual_pivot") {
+        std::cerr << "Unknown variant: " << variant << std::endl;
+        return 1;
+    }
+    if (variant == "dual_pivot" && (kernel != "dutch" || pivot != LAST_PIVOT)) {
+        std::cerr << "The dual_pivot variant has no --partition and --pivot options" << std::endl;
+        return 1;
+    }
+    const SortFunction sort_fn = variant == "dual_pivot" ? dual_pivot_quick_sort : quick_3way_sort;
+
+    const std::string mode = args[1];
     const bool test_length = (mode == "length");
 
     // Default to exponential scaling if not specified
     bool linear_scaling = false;
-    if (argc >= 3) {
-        const std::string scaling_mode = argv[2];
+    if (args.size() >= 3) {
+        const std::string scaling_mode = args[2];
         linear_scaling = (scaling_mode == "linear");
     }
 
     // Output filename
     std::string output_file;
-    if (argc >= 4) {
-        output_file = argv[3];
+    if (args.size() >= 4) {
+        output_file = args[3];
     } else {
         // Generate a filename based on test parameters and timestamp
-        output_file = generate_filename(test_length ? "length" : "max", linear_scaling, "quick_3way_sort");
+        std::string sort_type = variant == "dual_pivot" ? "dual_pivot_quick_sort" : "quick_3way_sort";
+        if (kernel != "dutch") {
+            sort_type += "_" + kernel + "_partition";
+        }
+        if (pivot != LAST_PIVOT) {
+            sort_type += "_" + pivot_name + "_pivot";
+        }
+        if (order != "random") {
+            sort_type += "_" + order;
+        }
+        output_file = generate_filename(test_length ? "length" : "max", linear_scaling, sort_type);
     }
 
     std::vector<RunResult> runs;
@@ -157,7 +213,7 @@ int main(const int argc, char *argv[]) {
     bool vary_length;
     if (test_length) {
         min_param = 100; // min_length
-        max_param = 100000; // max_length
+        max_param = std::stoi(get_option(argc, argv, "max-length", "100000")); // max_length
         vary_length = true;
     } else {
         min_param = 10; // min_max
@@ -168,8 +224,33 @@ int main(const int argc, char *argv[]) {
     // Generate sample points based on scaling type
     std::vector<int> sample_points = generate_sample_points(min_param, max_param, NUM_SAMPLES, linear_scaling);
 
-    // Run tests for each sample point
-    for (const int param_value: sample_points) {
+    // Allocate the buffers once for the largest arrays of the sweep
+    BenchmarkArena arena((vary_length ? max_param : 100000) * sizeof(int), has_flag(argc, argv, "huge-pages"));
+
+    // Count the hardware events of the timed loops if requested
+    if (has_flag(argc, argv, "counters")) {
+        enable_perf_counters();
+    }
+
+    // Select whether the timed loops measure the copies of the input or only the sorts
+    const std::string timing = get_option(argc, argv, "timing", "total");
+    TimingMode timing_mode;
+    if (!parse_timing_mode(timing, &timing_mode)) {
+        std::cerr << "Unknown timing mode: " << timing << std::endl;
+        return 1;
+    }
+    set_timing_mode(timing_mode);
+
+    // Shard the sample points across worker processes pinned to the given cores, if any
+    const std::string cores_option = get_option(argc, argv, "cores", "");
+    std::vector<int> cores;
+    if (!parse_core_list(cores_option, &cores)) {
+        std::cerr << "Invalid list of cores: " << cores_option << std::endl;
+        return 1;
+    }
+
+    // Run tests for each sample point, sharded across the cores if requested
+    const bool completed = run_sweep(sample_points, cores, &runs, [&](const int param_value) {
         RunResult run = {};
 
         if (vary_length) {
@@ -183,18 +264,22 @@ int main(const int argc, char *argv[]) {
         // Run multiple times for each sample point
         for (int r = 0; r < NUM_RUNS; r++) {
             // Generate input data with appropriate parameters
-            const auto data = new int[run.length];
+            const auto data = arena.get<int>(INPUT_BUFFER, run.length);
             generate_input_data(data, run.length, run.min, run.max);
+            arrange_input_data(data, run.length, order);
             // Execute and record time
-            run.time[r] = benchmark_algorithm(run.length, data);
-            // Free the allocated memory
-            delete[] data;
+            run.time[r] = benchmark_algorithm(run.length, data, &arena, partition_fn, pivot, sort_fn);
+            add_perf_counters(&run);
+            add_copy_time(&run);
         }
 
         // Print results for this run
         std::cout << "Length: " << run.length << ", Min: " << run.min << ", Max: " << run.max << std::endl;
 
-        runs.push_back(run);
+        return run;
+    });
+    if (!completed) {
+        return 1;
     }
 
     // Write results to CSV file
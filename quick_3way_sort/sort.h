@@ -1,41 +1,59 @@
 #ifndef QUICK3WAY_SORT_H
 #define QUICK3WAY_SORT_H
 
+#include <string>
+
+#include "arena.h"
+#include "partition.h"
+
 /**
- * @brief Partitions the array into three parts for the 3-way quick sort.
- *
- * This function partitions the subarray a[i...j-1] into three parts:
- * - Elements less than the pivot.
- * - Elements equal to the pivot.
- * - Elements greater than the pivot.
- *
- * The pivot is chosen as the last element of the subarray (a[j-1]). It rearranges
- * the elements so that [i, k) contains elements less than the pivot, [k, l) contains
- * elements equal to the pivot, and [l, j) contains elements greater than the pivot.
- *
+ * @brief Recursive 3-way QuickSort function (sort_lib::quick_3way_sort on int).
  * @param a Pointer to the array of integers.
- * @param i Starting index of the subarray.
+ * @param i The starting index of the subarray.
  * @param j One past the last index of the subarray.
- * @param k Pointer to store the starting index of the equal-to-pivot region.
- * @param l Pointer to store the ending index (exclusive) of the equal-to-pivot region.
+ * @param partition_fn The 3-way partition function used to split the subarrays.
+ * @param pivot The pivot policy.
  */
-void partition_3way(int *a, int i, int j, int *k, int *l);
+void quick_3way_sort(int *a, int i, int j, Partition3WayFunction partition_fn = partition_3way,
+                     PivotPolicy pivot = LAST_PIVOT);
 
 /**
- * @brief Recursive 3-way QuickSort function.
+ * @brief Dual-pivot QuickSort function (sort_lib::dual_pivot_quick_sort on int).
+ *
+ * The dual-pivot partition chooses its own two pivots, so the partition function and the pivot policy of the
+ * signature are not used.
+ *
  * @param a Pointer to the array of integers.
  * @param i The starting index of the subarray.
  * @param j One past the last index of the subarray.
  */
-void quick_3way_sort(int *a, int i, int j);
+void dual_pivot_quick_sort(int *a, int i, int j, Partition3WayFunction = partition_3way, PivotPolicy = LAST_PIVOT);
+
+/**
+ * @brief Signature of the sort functions of this executable
+ */
+typedef void (*SortFunction)(int *a, int i, int j, Partition3WayFunction partition_fn, PivotPolicy pivot);
+
+/**
+ * @brief Get the 3-way partition function with the given name
+ * @param name "dutch", "simd" or "bentley_mcilroy"
+ * @return the partition function, or nullptr if the name is unknown
+ */
+Partition3WayFunction get_partition_3way_function(const std::string &name);
 
 /**
  * Execute the sort algorithm
  * @param n The length of the array
  * @param data The array of integers
+ * @param arena The buffers of the benchmark
+ * @param partition_fn The 3-way partition function used by the sort
+ * @param pivot The pivot policy used by the sort
+ * @param sort_fn The sort function to measure
  * @return The execution time in nanoseconds
  */
-long long benchmark_algorithm(int n, int data[]);
+long long benchmark_algorithm(int n, int data[], BenchmarkArena *arena,
+                              Partition3WayFunction partition_fn = partition_3way, PivotPolicy pivot = LAST_PIVOT,
+                              SortFunction sort_fn = quick_3way_sort);
 
 /**
  * Main function to run the sort algorithm
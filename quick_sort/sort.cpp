@@ -3,11 +3,13 @@
 #include <cmath>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#include "quick_sort.h"
 #include "sort.h"
 #include "utils.h"
 
@@ -15,64 +17,85 @@
 
 // Partition function to rearrange the elements around the pivot
 int partition(int *a, const int i, const int j) {
-    int k = i; // index of the pivot's final position after the partition function
-    const int pivot = a[j - 1]; // Choose the last element as the pivot
-
-    for (int l = i; l < j; l++) { // Exclude pivot from comparisons
-        if (a[l] <= pivot) {
-            swap(a, k, l); // Place smaller elements on the left
-            k++;
-        }
-    }
-    return k - 1; // Return the pivot's final position
+    return sort_lib::partition(a, i, j, std::less<>());
 }
 
 // QuickSort function to sort the subarray a[i:j] (j exclusive)
-void quick_sort(int *a, const int i, const int j) {
-    // Base case: array of size 0 or 1
-    if (j - i <= 1) {
-        return;
-    }
-
-    // Inductive case: partition the array and sort the partitions
-    const int k = partition(a, i, j);
-    quick_sort(a, i, k); // Sort elements less than or equal to the pivot
-    quick_sort(a, k + 1, j); // Sort elements greater than the pivot
+void quick_sort(int *a, const int i, const int j, const PartitionFunction partition_fn, const PivotPolicy pivot) {
+    with_pivot_policy(pivot, [=](auto pivot_fn) {
+        sort_lib::quick_sort(a, i, j, std::less<>(), PartitionCaller{partition_fn}, pivot_fn);
+    });
 }
 
-// ------------------------ Benchmarking Code ------------------------
-
-long long benchmark_algorithm(const int n, int data[]) {
-    // Pre allocate the memory to avoid the overhead of malloc
-    auto *data_copy = new int[n];
+// IntroSort function to sort the subarray a[i:j] (j exclusive)
+void intro_sort(int *a, const int i, const int j, const PartitionFunction partition_fn, const PivotPolicy pivot) {
+    with_pivot_policy(pivot, [=](auto pivot_fn) {
+        sort_lib::intro_sort(a, i, j, std::less<>(), PartitionCaller{partition_fn}, pivot_fn);
+    });
+}
 
-    // Get the resolution of the clock
-    const auto min_time = get_minimum_time();
+// Task of the parallel QuickSort
+void parallel_quick_sort_task(int *a, int i, const int j, TaskPool *pool, TaskGroup *group,
+                              const PartitionFunction partition_fn) {
+    // Split the subarray until it is small enough to be sorted sequentially
+    while (j - i > PARALLEL_CUTOFF) {
+        const int k = partition_fn(a, i, j);
+        // Let any worker sort the elements less than or equal to the pivot
+        pool->spawn(*group, [a, i, k, pool, group, partition_fn] {
+            parallel_quick_sort_task(a, i, k, pool, group, partition_fn);
+        });
+        // Keep sorting the elements greater than the pivot on this worker
+        i = k + 1;
+    }
 
-    // Initialize the clock to measure the execution time
-    long long elapsed = 0;
-    // Measure the elapsed time
-    int i = 0; // Counter to measure the number of iterations
-    const time_point_t start = std::chrono::steady_clock::now(); // Start the clock
-    while (elapsed < min_time) { // Continue until the minimum time is reached
-        // Increment the counter
-        i++;
+    quick_sort(a, i, j, partition_fn);
+}
 
-        // Duplicate the input data
-        memcpy(data_copy, data, n * sizeof(int));
+// Parallel QuickSort function to sort the subarray a[i:j] (j exclusive)
+void parallel_quick_sort(int *a, const int i, const int j, TaskPool *pool, const PartitionFunction partition_fn) {
+    TaskGroup group;
+    pool->spawn(group, [a, i, j, pool, &group, partition_fn] {
+        parallel_quick_sort_task(a, i, j, pool, &group, partition_fn);
+    });
+    pool->wait(group);
+}
 
-        // Call the sort function
-        quick_sort(data_copy, 0, n);
-        // Measure the elapsed time
-        time_point_t end = std::chrono::steady_clock::now();
-        elapsed = std::chrono::duration_cast<time_unit_t>(end - start).count();
-    }
+// ------------------------ Benchmarking Code ------------------------
 
-    // Free the allocated memory
-    delete[] data_copy;
+long long benchmark_algorithm(const int n, int data[], BenchmarkArena *arena, const PartitionFunction partition_fn,
+                              const SortFunction sort_fn, const PivotPolicy pivot) {
+    // Reuse the buffers of the arena to avoid the overhead of malloc
+    const int ring_size = copy_ring_size(n * sizeof(int));
+    auto *data_copy = arena->get<int>(COPY_BUFFER, static_cast<long long>(ring_size) * n);
+
+    return measure_algorithm(
+            ring_size,
+            [&](const int k) {
+                // Duplicate the input data
+                memcpy(data_copy + static_cast<long long>(k) * n, data, n * sizeof(int));
+            },
+            [&](const int k) {
+                // Call the sort function
+                sort_fn(data_copy + static_cast<long long>(k) * n, 0, n, partition_fn, pivot);
+            });
+}
 
-    // Compute the elapsed time in nanoseconds
-    return elapsed / i;
+long long benchmark_parallel_algorithm(const int n, int data[], BenchmarkArena *arena, TaskPool *pool,
+                                       const PartitionFunction partition_fn) {
+    // Reuse the buffers of the arena to avoid the overhead of malloc
+    const int ring_size = copy_ring_size(n * sizeof(int));
+    auto *data_copy = arena->get<int>(COPY_BUFFER, static_cast<long long>(ring_size) * n);
+
+    return measure_algorithm(
+            ring_size,
+            [&](const int k) {
+                // Duplicate the input data
+                memcpy(data_copy + static_cast<long long>(k) * n, data, n * sizeof(int));
+            },
+            [&](const int k) {
+                // Call the sort function
+                parallel_quick_sort(data_copy + static_cast<long long>(k) * n, 0, n, pool, partition_fn);
+            });
 }
 
 // ------------------------ Main Function ------------------------
@@ -87,8 +110,49 @@ int main(int argc, char *argv[]) {
     const int n = data.size();
     int *arr = data.data();
 
-    // Execute the sort algorithm
-    quick_sort(arr, 0, n);
+    // Select the partition function
+    const std::string kernel = get_option(argc, argv, "partition", "lomuto");
+    const PartitionFunction partition_fn = get_partition_function(kernel, partition);
+    if (partition_fn == nullptr) {
+        std::cerr << "Unknown partition function: " << kernel << std::endl;
+        return 1;
+    }
+
+    // Select the pivot policy
+    const std::string pivot_name = get_option(argc, argv, "pivot", "last");
+    PivotPolicy pivot;
+    if (!parse_pivot_policy(pivot_name, &pivot)) {
+        std::cerr << "Unknown pivot policy: " << pivot_name << std::endl;
+        return 1;
+    }
+
+    // Select the sort function
+    const std::string variant = get_option(argc, argv, "variant", "quick");
+    if (variant != "quick" && variant != "intro") {
+        std::cerr << "Unknown variant: " << variant << std::endl;
+        return 1;
+    }
+
+    // The parallel sort has no variant and only uses the last pivot
+    const int num_threads = std::stoi(get_option(argc, argv, "threads", "1"));
+    if (num_threads > 1 && variant != "quick") {
+        std::cerr << "The " << variant << " variant has no parallel version" << std::endl;
+        return 1;
+    }
+    if (num_threads > 1 && pivot != LAST_PIVOT) {
+        std::cerr << "The parallel sort only uses the last pivot" << std::endl;
+        return 1;
+    }
+
+    // Execute the sort algorithm, in parallel if a thread count is given
+    if (num_threads > 1) {
+        TaskPool pool(num_threads);
+        parallel_quick_sort(arr, 0, n, &pool, partition_fn);
+    } else if (variant == "intro") {
+        intro_sort(arr, 0, n, partition_fn, pivot);
+    } else {
+        quick_sort(arr, 0, n, partition_fn, pivot);
+    }
 
     // Print the sorted array
     for (int i = 0; i < n; i++) {
@@ -101,32 +165,106 @@ int main(int argc, char *argv[]) {
 #else
 
 int main(const int argc, char *argv[]) {
-    set_cpu_affinity();
+    const std::vector<std::string> args = get_positional_arguments(argc, argv);
+
+    if (args.size() < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [length|max] [linear|exponential] [output_file] [--threads=N] [--max-length=N]"
+                     " [--partition=lomuto|block|simd] [--variant=quick|intro]"
+                     " [--pivot=last|random|median3|ninther|median_of_medians]"
+                     " [--order=random|sorted|reversed|organ_pipe|nearly_sorted|shuffled_runs] [--seed=N]"
+                     " [--huge-pages] [--counters] [--timing=total|sort] [--cores=LIST]"
+                  << std::endl;
+        return 1;
+    }
 
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " [length|max] [linear|exponential] [output_file]" << std::endl;
+    // Select the sort function
+    const std::string variant = get_option(argc, argv, "variant", "quick");
+    if (variant != "quick" && variant != "intro") {
+        std::cerr << "Unknown variant: " << variant << std::endl;
         return 1;
     }
+    const SortFunction sort_fn = variant == "intro" ? intro_sort : quick_sort;
 
-    const std::string mode = argv[1];
+    // Select the order of the input data
+    const std::string order = get_option(argc, argv, "order", "random");
+    if (!is_valid_input_order(order)) {
+        std::cerr << "Unknown input order: " << order << std::endl;
+        return 1;
+    }
+
+    // Generate the same input data as the other executables run with the same seed
+    const std::string seed = get_option(argc, argv, "seed", "");
+    if (!seed.empty()) {
+        set_input_seed(std::stoul(seed));
+    }
+
+    // Select the partition function
+    const std::string kernel = get_option(argc, argv, "partition", "lomuto");
+    const PartitionFunction partition_fn = get_partition_function(kernel, partition);
+    if (partition_fn == nullptr) {
+        std::cerr << "Unknown partition function: " << kernel << std::endl;
+        return 1;
+    }
+
+    // Select the pivot policy
+    const std::string pivot_name = get_option(argc, argv, "pivot", "last");
+    PivotPolicy pivot;
+    if (!parse_pivot_policy(pivot_name, &pivot)) {
+        std::cerr << "Unknown pivot policy: " << pivot_name << std::endl;
+        return 1;
+    }
+
+    // The parallel sort runs on all the requested cores, so the process is not pinned to the first one
+    const std::string threads_option = get_option(argc, argv, "threads", "");
+    const bool parallel = !threads_option.empty();
+    const int num_threads = parallel ? std::stoi(threads_option) : 1;
+    if (parallel && variant != "quick") {
+        std::cerr << "The " << variant << " variant has no parallel version" << std::endl;
+        return 1;
+    }
+    if (parallel && pivot != LAST_PIVOT) {
+        std::cerr << "The parallel sort only uses the last pivot" << std::endl;
+        return 1;
+    }
+    if (parallel) {
+        set_process_priority();
+    } else {
+        set_cpu_affinity();
+    }
+
+    const std::string mode = args[1];
     const bool test_length = (mode == "length");
 
     // Default to exponential scaling if not specified
     bool linear_scaling = false;
-    if (argc >= 3) {
-        const std::string scaling_mode = argv[2];
+    if (args.size() >= 3) {
+        const std::string scaling_mode = args[2];
         linear_scaling = (scaling_mode == "linear");
     }
 
     // Output filename
     std::string output_file;
-    if (argc >= 4) {
-        output_file = argv[3];
+    if (args.size() >= 4) {
+        output_file = args[3];
     } else {
         // Generate a filename based on test parameters and timestamp
-        output_file = generate_filename(test_length ? "length" : "max", linear_scaling, "quick_sort");
+        std::string sort_type = parallel ? "parallel_quick_sort" : variant + "_sort";
+        if (kernel != "lomuto") {
+            sort_type += "_" + kernel + "_partition";
+        }
+        if (pivot != LAST_PIVOT) {
+            sort_type += "_" + pivot_name + "_pivot";
+        }
+        if (order != "random") {
+            sort_type += "_" + order;
+        }
+        output_file = generate_filename(test_length ? "length" : "max", linear_scaling, sort_type);
     }
 
+    // Create the pool once, so that the threads are not started in the timed loop
+    TaskPool pool(num_threads);
+
     std::vector<RunResult> runs;
 
     // Determine which parameter to vary and its range
@@ -134,7 +272,7 @@ int main(const int argc, char *argv[]) {
     bool vary_length;
     if (test_length) {
         min_param = 100; // min_length
-        max_param = 100000; // max_length
+        max_param = std::stoi(get_option(argc, argv, "max-length", "100000")); // max_length
         vary_length = true;
     } else {
         min_param = 10; // min_max
@@ -145,8 +283,43 @@ int main(const int argc, char *argv[]) {
     // Generate sample points based on scaling type
     std::vector<int> sample_points = generate_sample_points(min_param, max_param, NUM_SAMPLES, linear_scaling);
 
-    // Run tests for each sample point
-    for (const int param_value: sample_points) {
+    // Allocate the buffers once for the largest arrays of the sweep
+    BenchmarkArena arena((vary_length ? max_param : 100000) * sizeof(int), has_flag(argc, argv, "huge-pages"));
+
+    // Count the hardware events of the timed loops if requested
+    if (has_flag(argc, argv, "counters")) {
+        // The counters only follow the calling thread, they would miss the work of the other threads of the pool
+        if (parallel) {
+            std::cerr << "The hardware counters only count the calling thread, --counters cannot be used with --threads"
+                      << std::endl;
+            return 1;
+        }
+        enable_perf_counters();
+    }
+
+    // Select whether the timed loops measure the copies of the input or only the sorts
+    const std::string timing = get_option(argc, argv, "timing", "total");
+    TimingMode timing_mode;
+    if (!parse_timing_mode(timing, &timing_mode)) {
+        std::cerr << "Unknown timing mode: " << timing << std::endl;
+        return 1;
+    }
+    set_timing_mode(timing_mode);
+
+    // Shard the sample points across worker processes pinned to the given cores, if any
+    const std::string cores_option = get_option(argc, argv, "cores", "");
+    std::vector<int> cores;
+    if (!parse_core_list(cores_option, &cores)) {
+        std::cerr << "Invalid list of cores: " << cores_option << std::endl;
+        return 1;
+    }
+    if (parallel && !cores.empty()) {
+        std::cerr << "The workers of --cores are single-threaded, --threads cannot be used with --cores" << std::endl;
+        return 1;
+    }
+
+    // Run tests for each sample point, sharded across the cores if requested
+    const bool completed = run_sweep(sample_points, cores, &runs, [&](const int param_value) {
         RunResult run = {};
 
         if (vary_length) {
@@ -160,18 +333,23 @@ int main(const int argc, char *argv[]) {
         // Run multiple times for each sample point
         for (int r = 0; r < NUM_RUNS; r++) {
             // Generate input data with appropriate parameters
-            const auto data = new int[run.length];
+            const auto data = arena.get<int>(INPUT_BUFFER, run.length);
             generate_input_data(data, run.length, run.min, run.max);
+            arrange_input_data(data, run.length, order);
             // Execute and record time
-            run.time[r] = benchmark_algorithm(run.length, data);
-            // Free the allocated memory
-            delete[] data;
+            run.time[r] = parallel ? benchmark_parallel_algorithm(run.length, data, &arena, &pool, partition_fn)
+                                   : benchmark_algorithm(run.length, data, &arena, partition_fn, sort_fn, pivot);
+            add_perf_counters(&run);
+            add_copy_time(&run);
         }
 
         // Print results for this run
         std::cout << "Length: " << run.length << ", Min: " << run.min << ", Max: " << run.max << std::endl;
 
-        runs.push_back(run);
+        return run;
+    });
+    if (!completed) {
+        return 1;
     }
 
     // Write results to CSV file
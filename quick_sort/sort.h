@@ -1,9 +1,16 @@
 #ifndef QUICKSORT_SORT_H
 #define QUICKSORT_SORT_H
 
+#include "arena.h"
+#include "partition.h"
+#include "task_pool.h"
+
+// Subarrays shorter than this are sorted sequentially by the parallel quick sort,
+// so that the cost of a task stays small compared to the work it performs.
+constexpr int PARALLEL_CUTOFF = 1 << 14;
 
 /**
- * @brief Partitions the array
+ * @brief Partitions the array (sort_lib::partition on int)
  *
  * This function rearranges elements in the subarray such that all elements less than
  * or equal to the pivot are placed to its left and all greater elements to its right.
@@ -18,20 +25,81 @@ int partition(int *a, int i, int j);
 
 
 /**
- * QuickSort function to sort the subarray a[i:j] (j exclusive)
+ * QuickSort function to sort the subarray a[i:j] (j exclusive), with sort_lib::quick_sort
  * @param a The array of integers
  * @param i The index of the first element
  * @param j The index of the last element
+ * @param partition_fn The partition function used to split the subarrays
+ * @param pivot The pivot policy
+ */
+void quick_sort(int *a, int i, int j, PartitionFunction partition_fn = partition, PivotPolicy pivot = LAST_PIVOT);
+
+/**
+ * @brief Signature of the sequential sort functions of this executable
  */
-void quick_sort(int *a, int i, int j);
+typedef void (*SortFunction)(int *a, int i, int j, PartitionFunction partition_fn, PivotPolicy pivot);
+
+/**
+ * IntroSort function to sort the subarray a[i:j] (j exclusive) in O(n log n) time in the worst case,
+ * with sort_lib::intro_sort
+ * @param a The array of integers
+ * @param i The index of the first element
+ * @param j The index of the last element
+ * @param partition_fn The partition function used to split the subarrays
+ * @param pivot The pivot policy
+ */
+void intro_sort(int *a, int i, int j, PartitionFunction partition_fn = partition, PivotPolicy pivot = LAST_PIVOT);
+
+/**
+ * @brief Task of the parallel QuickSort
+ *
+ * Partitions the subarray, spawns the sort of the left partition on the pool and keeps
+ * partitioning the right one, until the subarray is shorter than PARALLEL_CUTOFF.
+ *
+ * @param a The array of integers
+ * @param i The index of the first element
+ * @param j The index of the last element (exclusive)
+ * @param pool The pool that executes the spawned tasks
+ * @param group The group that counts the pending tasks of the sort
+ * @param partition_fn The partition function used to split the subarrays
+ */
+void parallel_quick_sort_task(int *a, int i, int j, TaskPool *pool, TaskGroup *group,
+                              PartitionFunction partition_fn = partition);
+
+/**
+ * Parallel QuickSort function to sort the subarray a[i:j] (j exclusive) on a work-stealing pool
+ * @param a The array of integers
+ * @param i The index of the first element
+ * @param j The index of the last element
+ * @param pool The pool that executes the sort
+ * @param partition_fn The partition function used to split the subarrays
+ */
+void parallel_quick_sort(int *a, int i, int j, TaskPool *pool, PartitionFunction partition_fn = partition);
 
 /**
  * Execute the sort algorithm
  * @param n The length of the array
  * @param data The array of integers
+ * @param arena The buffers of the benchmark
+ * @param partition_fn The partition function used by the sort
+ * @param sort_fn The sort function to measure
+ * @param pivot The pivot policy used by the sort
+ * @return The execution time in nanoseconds
+ */
+long long benchmark_algorithm(int n, int data[], BenchmarkArena *arena, PartitionFunction partition_fn = partition,
+                              SortFunction sort_fn = quick_sort, PivotPolicy pivot = LAST_PIVOT);
+
+/**
+ * Execute the parallel sort algorithm
+ * @param n The length of the array
+ * @param data The array of integers
+ * @param arena The buffers of the benchmark
+ * @param pool The pool that executes the sort
+ * @param partition_fn The partition function used by the sort
  * @return The execution time in nanoseconds
  */
-long long benchmark_algorithm(int n, int data[]);
+long long benchmark_parallel_algorithm(int n, int data[], BenchmarkArena *arena, TaskPool *pool,
+                                       PartitionFunction partition_fn = partition);
 
 /**
  * Main function to run the sort algorithm
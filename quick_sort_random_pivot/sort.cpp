@@ -3,11 +3,13 @@
 #include <cmath>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#include "randomized_quick_sort.h"
 #include "sort.h"
 #include "utils.h"
 
@@ -15,71 +17,57 @@
 
 // Partition function to rearrange the elements around the pivot
 int partition(int *a, const int i, const int j) {
-    int k = i; // index of the pivot's final position after the partition function
-    const int pivot = a[j - 1]; // Choose the last element as the pivot
-
-    for (int l = i; l < j; l++) { // Exclude pivot from comparisons
-        if (a[l] <= pivot) {
-            swap(a, k, l); // Place smaller elements on the left
-            k++;
-        }
-    }
-    return k - 1; // Return the pivot's final position
+    return sort_lib::partition(a, i, j, std::less<>());
 }
 
-// Generate a random number between i and j
-int random_between(const int i, const int j) {
-    return i + rand() % (j - i + 1); // Generate a random number between i and j
-}
-
-// Randomized partition function to rearrange the elements around the pivot
-int randomized_partition(int *a, int i, int j) {
-    const int x = random_between(i, j - 1); // Select a random index between i and j-1
-    swap(a, j - 1, x); // Swap it with the last element
-    return partition(a, i, j); // Perform partitioning
+// Function to get a random generator by name
+bool parse_random_generator(const std::string &name, RandomGenerator *generator) {
+    if (name == "wyrand") {
+        *generator = WYRAND_GENERATOR;
+    } else if (name == "xoshiro") {
+        *generator = XOSHIRO_GENERATOR;
+    } else if (name == "libc") {
+        *generator = LIBC_GENERATOR;
+    } else {
+        return false;
+    }
+    return true;
 }
 
-void randomized_quick_sort(int *a, const int i, const int j) {
-    if (i < j) {
-        const int q = randomized_partition(a, i, j);
-        randomized_quick_sort(a, i, q);
-        randomized_quick_sort(a, q + 1, j);
+// Randomized QuickSort function to sort the subarray a[i:j] (j exclusive)
+void randomized_quick_sort(int *a, const int i, const int j, const PartitionFunction partition_fn,
+                           const RandomGenerator generator, const uint64_t seed) {
+    const PartitionCaller partition_caller{partition_fn};
+    if (generator == XOSHIRO_GENERATOR) {
+        sort_lib::randomized_quick_sort<int, std::less<>, PartitionCaller, sort_lib::Xoshiro256>(
+            a, i, j, std::less<>(), partition_caller, seed);
+    } else if (generator == LIBC_GENERATOR) {
+        sort_lib::randomized_quick_sort<int, std::less<>, PartitionCaller, sort_lib::LibcRandom>(
+            a, i, j, std::less<>(), partition_caller, seed);
+    } else {
+        sort_lib::randomized_quick_sort(a, i, j, std::less<>(), partition_caller, seed);
     }
 }
 
 // ------------------------ Benchmarking Code ------------------------
 
-long long benchmark_algorithm(const int n, int data[]) {
-    // Pre allocate the memory to avoid the overhead of malloc
-    auto *data_copy = new int[n];
-
-    // Get the resolution of the clock
-    const auto min_time = get_minimum_time();
-
-    // Initialize the clock to measure the execution time
-    long long elapsed = 0;
-    // Measure the elapsed time
-    int i = 0; // Counter to measure the number of iterations
-    const time_point_t start = std::chrono::steady_clock::now(); // Start the clock
-    while (elapsed < min_time) { // Continue until the minimum time is reached
-        // Increment the counter
-        i++;
-
-        // Duplicate the input data
-        memcpy(data_copy, data, n * sizeof(int));
-
-        // Call the sort function
-        randomized_quick_sort(data_copy, 0, n);
-        // Measure the elapsed time
-        time_point_t end = std::chrono::steady_clock::now();
-        elapsed = std::chrono::duration_cast<time_unit_t>(end - start).count();
-    }
-
-    // Free the allocated memory
-    delete[] data_copy;
-
-    // Compute the elapsed time in nanoseconds
-    return elapsed / i;
+long long benchmark_algorithm(const int n, int data[], BenchmarkArena *arena,
+                              const PartitionFunction partition_fn, const RandomGenerator generator,
+                              const uint64_t seed) {
+    // Reuse the buffers of the arena to avoid the overhead of malloc
+    const int ring_size = copy_ring_size(n * sizeof(int));
+    auto *data_copy = arena->get<int>(COPY_BUFFER, static_cast<long long>(ring_size) * n);
+
+    return measure_algorithm(
+            ring_size,
+            [&](const int k) {
+                // Duplicate the input data
+                memcpy(data_copy + static_cast<long long>(k) * n, data, n * sizeof(int));
+            },
+            [&](const int k) {
+                // Call the sort function
+                randomized_quick_sort(data_copy + static_cast<long long>(k) * n, 0, n, partition_fn, generator, seed);
+            });
 }
 
 // ------------------------ Main Function ------------------------
@@ -94,8 +82,26 @@ int main(int argc, char *argv[]) {
     const int n = data.size();
     int *arr = data.data();
 
+    // Select the partition function
+    const std::string kernel = get_option(argc, argv, "partition", "lomuto");
+    const PartitionFunction partition_fn = get_partition_function(kernel, partition);
+    if (partition_fn == nullptr) {
+        std::cerr << "Unknown partition function: " << kernel << std::endl;
+        return 1;
+    }
+
+    // Select the random generator of the pivots
+    const std::string rng = get_option(argc, argv, "rng", "wyrand");
+    RandomGenerator generator;
+    if (!parse_random_generator(rng, &generator)) {
+        std::cerr << "Unknown random generator: " << rng << std::endl;
+        return 1;
+    }
+    const uint64_t pivot_seed = std::stoull(get_option(argc, argv, "pivot-seed",
+                                                       std::to_string(sort_lib::DEFAULT_RANDOM_SEED)));
+
     // Execute the sort algorithm
-    randomized_quick_sort(arr, 0, n);
+    randomized_quick_sort(arr, 0, n, partition_fn, generator, pivot_seed);
 
     // Print the sorted array
     for (int i = 0; i < n; i++) {
@@ -110,28 +116,77 @@ int main(int argc, char *argv[]) {
 int main(const int argc, char *argv[]) {
     set_cpu_affinity();
 
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " [length|max] [linear|exponential] [output_file]" << std::endl;
+    const std::vector<std::string> args = get_positional_arguments(argc, argv);
+
+    if (args.size() < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [length|max] [linear|exponential] [output_file] [--max-length=N]"
+                     " [--partition=lomuto|block|simd]"
+                     " [--rng=wyrand|xoshiro|libc] [--pivot-seed=N]"
+                     " [--order=random|sorted|reversed|organ_pipe|nearly_sorted|shuffled_runs] [--seed=N]"
+                     " [--huge-pages] [--counters] [--timing=total|sort] [--cores=LIST]"
+                  << std::endl;
+        return 1;
+    }
+
+    // Select the order of the input data
+    const std::string order = get_option(argc, argv, "order", "random");
+    if (!is_valid_input_order(order)) {
+        std::cerr << "Unknown input order: " << order << std::endl;
+        return 1;
+    }
+
+    // Generate the same input data as the other executables run with the same seed
+    const std::string seed = get_option(argc, argv, "seed", "");
+    if (!seed.empty()) {
+        set_input_seed(std::stoul(seed));
+    }
+
+    // Select the partition function
+    const std::string kernel = get_option(argc, argv, "partition", "lomuto");
+    const PartitionFunction partition_fn = get_partition_function(kernel, partition);
+    if (partition_fn == nullptr) {
+        std::cerr << "Unknown partition function: " << kernel << std::endl;
+        return 1;
+    }
+
+    // Select the random generator of the pivots and its seed, fixed so that every run selects the same pivots
+    const std::string rng = get_option(argc, argv, "rng", "wyrand");
+    RandomGenerator generator;
+    if (!parse_random_generator(rng, &generator)) {
+        std::cerr << "Unknown random generator: " << rng << std::endl;
         return 1;
     }
+    const uint64_t pivot_seed = std::stoull(get_option(argc, argv, "pivot-seed",
+                                                       std::to_string(sort_lib::DEFAULT_RANDOM_SEED)));
 
-    const std::string mode = argv[1];
+    const std::string mode = args[1];
     const bool test_length = (mode == "length");
 
     // Default to exponential scaling if not specified
     bool linear_scaling = false;
-    if (argc >= 3) {
-        const std::string scaling_mode = argv[2];
+    if (args.size() >= 3) {
+        const std::string scaling_mode = args[2];
         linear_scaling = (scaling_mode == "linear");
     }
 
     // Output filename
     std::string output_file;
-    if (argc >= 4) {
-        output_file = argv[3];
+    if (args.size() >= 4) {
+        output_file = args[3];
     } else {
         // Generate a filename based on test parameters and timestamp
-        output_file = generate_filename(test_length ? "length" : "max", linear_scaling, "quick_sort_random_pivot");
+        std::string sort_type = "quick_sort_random_pivot";
+        if (kernel != "lomuto") {
+            sort_type += "_" + kernel + "_partition";
+        }
+        if (rng != "wyrand") {
+            sort_type += "_" + rng;
+        }
+        if (order != "random") {
+            sort_type += "_" + order;
+        }
+        output_file = generate_filename(test_length ? "length" : "max", linear_scaling, sort_type);
     }
 
     std::vector<RunResult> runs;
@@ -141,7 +196,7 @@ int main(const int argc, char *argv[]) {
     bool vary_length;
     if (test_length) {
         min_param = 100; // min_length
-        max_param = 100000; // max_length
+        max_param = std::stoi(get_option(argc, argv, "max-length", "100000")); // max_length
         vary_length = true;
     } else {
         min_param = 10; // min_max
@@ -152,8 +207,33 @@ int main(const int argc, char *argv[]) {
     // Generate sample points based on scaling type
     std::vector<int> sample_points = generate_sample_points(min_param, max_param, NUM_SAMPLES, linear_scaling);
 
-    // Run tests for each sample point
-    for (const int param_value: sample_points) {
+    // Allocate the buffers once for the largest arrays of the sweep
+    BenchmarkArena arena((vary_length ? max_param : 100000) * sizeof(int), has_flag(argc, argv, "huge-pages"));
+
+    // Count the hardware events of the timed loops if requested
+    if (has_flag(argc, argv, "counters")) {
+        enable_perf_counters();
+    }
+
+    // Select whether the timed loops measure the copies of the input or only the sorts
+    const std::string timing = get_option(argc, argv, "timing", "total");
+    TimingMode timing_mode;
+    if (!parse_timing_mode(timing, &timing_mode)) {
+        std::cerr << "Unknown timing mode: " << timing << std::endl;
+        return 1;
+    }
+    set_timing_mode(timing_mode);
+
+    // Shard the sample points across worker processes pinned to the given cores, if any
+    const std::string cores_option = get_option(argc, argv, "cores", "");
+    std::vector<int> cores;
+    if (!parse_core_list(cores_option, &cores)) {
+        std::cerr << "Invalid list of cores: " << cores_option << std::endl;
+        return 1;
+    }
+
+    // Run tests for each sample point, sharded across the cores if requested
+    const bool completed = run_sweep(sample_points, cores, &runs, [&](const int param_value) {
         RunResult run = {};
 
         if (vary_length) {
@@ -167,18 +247,22 @@ int main(const int argc, char *argv[]) {
         // Run multiple times for each sample point
         for (int r = 0; r < NUM_RUNS; r++) {
             // Generate input data with appropriate parameters
-            const auto data = new int[run.length];
+            const auto data = arena.get<int>(INPUT_BUFFER, run.length);
             generate_input_data(data, run.length, run.min, run.max);
+            arrange_input_data(data, run.length, order);
             // Execute and record time
-            run.time[r] = benchmark_algorithm(run.length, data);
-            // Free the allocated memory
-            delete[] data;
+            run.time[r] = benchmark_algorithm(run.length, data, &arena, partition_fn, generator, pivot_seed);
+            add_perf_counters(&run);
+            add_copy_time(&run);
         }
 
         // Print results for this run
         std::cout << "Length: " << run.length << ", Min: " << run.min << ", Max: " << run.max << std::endl;
 
-        runs.push_back(run);
+        return run;
+    });
+    if (!completed) {
+        return 1;
     }
 
     // Write results to CSV file
@@ -1,59 +1,71 @@
 #ifndef RANDOMIZED_QUICKSORT_SORT_H
 #define RANDOMIZED_QUICKSORT_SORT_H
 
+#include <cstdint>
+#include <string>
+
+#include "arena.h"
+#include "partition.h"
+#include "random.h"
 
 /**
- * @brief Partitions the array
- *
- * This function rearranges elements in the subarray such that all elements less than
- * or equal to the pivot are placed to its left and all greater elements to its right.
- * The pivot is chosen as the last element of the subarray.
- *
- * @param a Pointer to the array of integers.
- * @param i Starting index of the subarray.
- * @param j Ending index of the subarray (exclusive).
- * @return int The final index position of the pivot after partitioning.
+ * @brief Random generator that selects the pivots
  */
-int partition(int *a, int i, int j);
+enum RandomGenerator_t {
+    WYRAND_GENERATOR, // sort_lib::WyRand
+    XOSHIRO_GENERATOR, // sort_lib::Xoshiro256
+    LIBC_GENERATOR, // sort_lib::LibcRandom, the libc rand()
+} typedef RandomGenerator;
 
 /**
- * @brief Generates a random number between i and j
- *
- * @param i The lower bound of the random number.
- * @param j The upper bound of the random number.
- * @return int The random number generated.
+ * @brief Get the random generator with the given name
+ * @param name "wyrand", "xoshiro" or "libc"
+ * @param generator The generator, set if the name is known
+ * @return true if the name is known
  */
-int random_between(int i, int j);
+bool parse_random_generator(const std::string &name, RandomGenerator *generator);
 
 /**
- * @brief Randomized partition function
+ * @brief Partitions the array (sort_lib::partition on int)
  *
- * This function selects a random index between i and j-1, swaps it with the last element,
- * and then calls the partition function to rearrange the elements around the pivot.
+ * This function rearranges elements in the subarray such that all elements less than
+ * or equal to the pivot are placed to its left and all greater elements to its right.
+ * The pivot is chosen as the last element of the subarray.
  *
  * @param a Pointer to the array of integers.
  * @param i Starting index of the subarray.
  * @param j Ending index of the subarray (exclusive).
  * @return int The final index position of the pivot after partitioning.
  */
-int randomized_partition(int *a, int i, int j);
+int partition(int *a, int i, int j);
 
 /**
  * @brief Randomized quick sort algorithm
- * This function sorts the array of integers using the randomized quick sort algorithm.
+ * This function sorts the array of integers using sort_lib::randomized_quick_sort.
  * @param a Pointer to the array of integers.
  * @param i Starting index of the subarray.
  * @param j Ending index of the subarray (exclusive).
+ * @param partition_fn The partition function used to split the subarrays.
+ * @param generator The random generator that selects the pivots.
+ * @param seed The seed of the random generator.
  */
-void randomized_quick_sort(int *a, int i, int j);
+void randomized_quick_sort(int *a, int i, int j, PartitionFunction partition_fn = partition,
+                           RandomGenerator generator = WYRAND_GENERATOR,
+                           uint64_t seed = sort_lib::DEFAULT_RANDOM_SEED);
 
 /**
  * Execute the sort algorithm
  * @param n The length of the array
  * @param data The array of integers
+ * @param arena The buffers of the benchmark
+ * @param partition_fn The partition function used by the sort
+ * @param generator The random generator that selects the pivots
+ * @param seed The seed of the random generator, the same for every iteration
  * @return The execution time in nanoseconds
  */
-long long benchmark_algorithm(int n, int data[]);
+long long benchmark_algorithm(int n, int data[], BenchmarkArena *arena, PartitionFunction partition_fn = partition,
+                              RandomGenerator generator = WYRAND_GENERATOR,
+                              uint64_t seed = sort_lib::DEFAULT_RANDOM_SEED);
 
 /**
  * Main function to run the sort algorithm
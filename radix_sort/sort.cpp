@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "sort.h"
+#include "sorting_network.h"
+#include "utils.h"
+
+// ------------------------ Algorithm Code ------------------------
+
+int radix_passes(const int bits) {
+    return (KEY_BITS + bits - 1) / bits;
+}
+
+void radix_sort(const int n, int data[], int buffer[], int count[], const int bits) {
+    const int passes = radix_passes(bits);
+    const int buckets = 1 << bits;
+    const unsigned int mask = buckets - 1;
+
+    if (n < 2) {
+        return;
+    }
+
+    // Count the occurrences of every digit of every element in a single pass
+    memset(count, 0, passes * buckets * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        const unsigned int key = to_unsigned_key(data[i]);
+        for (int p = 0; p < passes; p++) {
+            count[p * buckets + ((key >> (p * bits)) & mask)]++;
+        }
+    }
+
+    int *src = data;
+    int *dst = buffer;
+    for (int p = 0; p < passes; p++) {
+        int *digit_count = count + p * buckets;
+        const int shift = p * bits;
+
+        // Skip the digit if it is the same for all the elements
+        if (digit_count[(to_unsigned_key(src[0]) >> shift) & mask] == n) {
+            continue;
+        }
+
+        // Calculate the starting position of each bucket
+        int sum = 0;
+        for (int b = 0; b < buckets; b++) {
+            const int c = digit_count[b];
+            digit_count[b] = sum;
+            sum += c;
+        }
+
+        // Move the elements to their bucket, keeping their relative order
+        for (int i = 0; i < n; i++) {
+            const unsigned int digit = (to_unsigned_key(src[i]) >> shift) & mask;
+            dst[digit_count[digit]++] = src[i];
+        }
+
+        std::swap(src, dst);
+    }
+
+    // Copy the result back if the last pass wrote into the buffer
+    if (src != data) {
+        memcpy(data, src, n * sizeof(int));
+    }
+}
+
+void msd_radix_sort(int data[], const int i, const int j, const int shift) {
+    constexpr int buckets = 1 << MSD_RADIX_BITS;
+    constexpr unsigned int mask = buckets - 1;
+
+    // Base case: small buckets are sorted with a sorting network, or with insertion sort if they are longer
+    if (j - i < MSD_THRESHOLD) {
+        if (j - i <= sort_lib::SMALL_SORT_THRESHOLD) {
+            sort_lib::network_sort(data, i, j, std::less<>());
+        } else {
+            insertion_sort(data, i, j - 1);
+        }
+        return;
+    }
+
+    // Count the occurrences of each digit
+    int count[buckets] = {};
+    for (int m = i; m < j; m++) {
+        count[(to_unsigned_key(data[m]) >> shift) & mask]++;
+    }
+
+    // Skip the digit if it is the same for all the elements
+    if (count[(to_unsigned_key(data[i]) >> shift) & mask] == j - i) {
+        if (shift > 0) {
+            msd_radix_sort(data, i, j, shift - MSD_RADIX_BITS);
+        }
+        return;
+    }
+
+    // Calculate the boundaries of each bucket
+    int start[buckets];
+    int next[buckets];
+    int sum = i;
+    for (int b = 0; b < buckets; b++) {
+        start[b] = sum;
+        next[b] = sum;
+        sum += count[b];
+    }
+
+    // Move each element to its bucket by following the permutation cycles
+    for (int b = 0; b < buckets; b++) {
+        const int end = start[b] + count[b];
+        while (next[b] < end) {
+            int value = data[next[b]];
+            unsigned int digit = (to_unsigned_key(value) >> shift) & mask;
+            while (digit != static_cast<unsigned int>(b)) {
+                const int temp = data[next[digit]];
+                data[next[digit]++] = value;
+                value = temp;
+                digit = (to_unsigned_key(value) >> shift) & mask;
+            }
+            data[next[b]++] = value;
+        }
+    }
+
+    // Sort each bucket on the next digit
+    if (shift > 0) {
+        for (int b = 0; b < buckets; b++) {
+            if (count[b] > 1) {
+                msd_radix_sort(data, start[b], start[b] + count[b], shift - MSD_RADIX_BITS);
+            }
+        }
+    }
+}
+
+// ------------------------ Benchmarking Code ------------------------
+
+long long benchmark_algorithm(const int n, int data[], BenchmarkArena *arena, const bool msd, const int bits) {
+    // Reuse the buffers of the arena to avoid the overhead of malloc
+    const int ring_size = copy_ring_size(n * sizeof(int));
+    auto *data_copy = arena->get<int>(COPY_BUFFER, static_cast<long long>(ring_size) * n);
+    auto *buffer = arena->get<int>(TEMP_BUFFER, n);
+    auto *count = arena->get<int>(COUNT_BUFFER, radix_passes(bits) << bits);
+
+    return measure_algorithm(
+            ring_size,
+            [&](const int k) {
+                // Duplicate the input data
+                memcpy(data_copy + static_cast<long long>(k) * n, data, n * sizeof(int));
+            },
+            [&](const int k) {
+                // Call the sort function
+                if (msd) {
+                    msd_radix_sort(data_copy + static_cast<long long>(k) * n, 0, n);
+                } else {
+                    radix_sort(n, data_copy + static_cast<long long>(k) * n, buffer, count, bits);
+                }
+            });
+}
+
+// ------------------------ Main Function ------------------------
+
+#ifndef BENCHMARK_MODE
+
+int main(int argc, char *argv[]) {
+    // Read array from stdin
+    std::vector<int> data = read_input_data();
+
+    // Convert the vector to an array
+    const int n = data.size();
+    int *arr = data.data();
+
+    // Select the variant of the algorithm
+    const std::string variant = get_option(argc, argv, "variant", "lsd");
+    const int bits = std::stoi(get_option(argc, argv, "bits", std::to_string(RADIX_BITS)));
+    if ((variant != "lsd" && variant != "msd") || (bits != 8 && bits != 11)) {
+        std::cerr << "Unknown variant: " << variant << " with " << bits << "-bit digits" << std::endl;
+        return 1;
+    }
+    const bool msd = variant == "msd";
+
+    // Pre allocate the memory
+    auto *buffer = new int[n];
+    auto *count = new int[radix_passes(bits) << bits];
+
+    // Execute the sort algorithm
+    if (msd) {
+        msd_radix_sort(arr, 0, n);
+    } else {
+        radix_sort(n, arr, buffer, count, bits);
+    }
+
+    // Print the sorted array
+    for (int i = 0; i < n; i++) {
+        std::cout << arr[i] << " ";
+    }
+
+    // Free the allocated memory
+    delete[] buffer;
+    delete[] count;
+
+    return 0;
+}
+
+#else
+
+int main(const int argc, char *argv[]) {
+    set_cpu_affinity();
+
+    const std::vector<std::string> args = get_positional_arguments(argc, argv);
+
+    if (args.size() < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [length|max] [linear|exponential] [output_file] [--variant=lsd|msd] [--bits=8|11]"
+                     " [--max-max=N] [--signed] [--seed=N] [--huge-pages] [--counters] [--timing=total|sort]"
+                     " [--cores=LIST]"
+                  << std::endl;
+        return 1;
+    }
+
+    // Select the variant of the algorithm
+    const std::string variant = get_option(argc, argv, "variant", "lsd");
+    const int bits = std::stoi(get_option(argc, argv, "bits", std::to_string(RADIX_BITS)));
+    if ((variant != "lsd" && variant != "msd") || (bits != 8 && bits != 11)) {
+        std::cerr << "Unknown variant: " << variant << " with " << bits << "-bit digits" << std::endl;
+        return 1;
+    }
+    const bool msd = variant == "msd";
+
+    // Generate keys in [-max, max] instead of [0, max]
+    const bool signed_keys = has_flag(argc, argv, "signed");
+
+    // Generate the same input data as the other executables run with the same seed
+    const std::string seed = get_option(argc, argv, "seed", "");
+    if (!seed.empty()) {
+        set_input_seed(std::stoul(seed));
+    }
+
+    const std::string mode = args[1];
+    const bool test_length = (mode == "length");
+
+    // Default to exponential scaling if not specified
+    bool linear_scaling = false;
+    if (args.size() >= 3) {
+        const std::string scaling_mode = args[2];
+        linear_scaling = (scaling_mode == "linear");
+    }
+
+    // Output filename
+    std::string output_file;
+    if (args.size() >= 4) {
+        output_file = args[3];
+    } else {
+        // Generate a filename based on test parameters and timestamp
+        std::string sort_type = msd ? "msd_radix_sort" : "radix_sort";
+        if (!msd && bits != RADIX_BITS) {
+            sort_type += "_" + std::to_string(bits) + "bit";
+        }
+        if (signed_keys) {
+            sort_type += "_signed";
+        }
+        output_file = generate_filename(test_length ? "length" : "max", linear_scaling, sort_type);
+    }
+
+    std::vector<RunResult> runs;
+
+    // Determine which parameter to vary and its range
+    int min_param, max_param;
+    bool vary_length;
+    if (test_length) {
+        min_param = 100; // min_length
+        max_param = 100000; // max_length
+        vary_length = true;
+    } else {
+        min_param = 10; // min_max
+        // The running time does not depend on the key range, which can be extended up to the full 31-bit range
+        max_param = std::stoi(get_option(argc, argv, "max-max", "1000000")); // max_max
+        vary_length = false;
+    }
+
+    // Generate sample points based on scaling type
+    std::vector<int> sample_points = generate_sample_points(min_param, max_param, NUM_SAMPLES, linear_scaling);
+
+    // Allocate the buffers once for the largest arrays of the sweep
+    BenchmarkArena arena((vary_length ? max_param : 100000) * sizeof(int), has_flag(argc, argv, "huge-pages"));
+
+    // Count the hardware events of the timed loops if requested
+    if (has_flag(argc, argv, "counters")) {
+        enable_perf_counters();
+    }
+
+    // Select whether the timed loops measure the copies of the input or only the sorts
+    const std::string timing = get_option(argc, argv, "timing", "total");
+    TimingMode timing_mode;
+    if (!parse_timing_mode(timing, &timing_mode)) {
+        std::cerr << "Unknown timing mode: " << timing << std::endl;
+        return 1;
+    }
+    set_timing_mode(timing_mode);
+
+    // Shard the sample points across worker processes pinned to the given cores, if any
+    const std::string cores_option = get_option(argc, argv, "cores", "");
+    std::vector<int> cores;
+    if (!parse_core_list(cores_option, &cores)) {
+        std::cerr << "Invalid list of cores: " << cores_option << std::endl;
+        return 1;
+    }
+
+    // Run tests for each sample point, sharded across the cores if requested
+    const bool completed = run_sweep(sample_points, cores, &runs, [&](const int param_value) {
+        RunResult run = {};
+
+        if (vary_length) {
+            run.max = 1000000;
+            run.length = param_value;
+        } else {
+            run.max = param_value;
+            run.length = 100000;
+        }
+        if (signed_keys) {
+            run.min = -run.max;
+        }
+
+        // Run multiple times for each sample point
+        for (int r = 0; r < NUM_RUNS; r++) {
+            // Generate input data with appropriate parameters
+            const auto data = arena.get<int>(INPUT_BUFFER, run.length);
+            generate_input_data(data, run.length, run.min, run.max);
+            // Execute and record time
+            run.time[r] = benchmark_algorithm(run.length, data, &arena, msd, bits);
+            add_perf_counters(&run);
+            add_copy_time(&run);
+        }
+
+        // Print results for this run
+        std::cout << "Length: " << run.length << ", Min: " << run.min << ", Max: " << run.max << std::endl;
+
+        return run;
+    });
+    if (!completed) {
+        return 1;
+    }
+
+    // Write results to CSV file
+    write_results_to_csv(output_file, runs);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include "arena.h"
+
+// Number of bits of the keys
+constexpr int KEY_BITS = 32;
+// Default width of a digit of the LSD radix sort, in bits.
+// 8-bit digits need 4 passes with a 1 KB histogram each, 11-bit digits need 3 passes with an 8 KB histogram each.
+constexpr int RADIX_BITS = 8;
+// Width of a digit of the MSD radix sort, in bits.
+constexpr int MSD_RADIX_BITS = 8;
+// Buckets of the MSD radix sort shorter than this are sorted with insertion sort.
+constexpr int MSD_THRESHOLD = 64;
+
+/**
+ * @brief Map a signed key to an unsigned key with the same order
+ *
+ * Flipping the sign bit moves the negative keys below the non-negative ones.
+ *
+ * @param key The signed key
+ * @return The unsigned key
+ */
+inline unsigned int to_unsigned_key(const int key) {
+    return static_cast<unsigned int>(key) ^ 0x80000000u;
+}
+
+/**
+ * @brief Get the number of digits of the keys
+ * @param bits The width of a digit in bits
+ * @return The number of passes of the LSD radix sort
+ */
+int radix_passes(int bits);
+
+/**
+ * @brief Perform LSD radix sort on the input array
+ *
+ * The histograms of all the digits are computed in a single pass over the input. Then, for each digit
+ * from the least significant one, the histogram is turned into the bucket offsets with a prefix sum and
+ * the elements are scattered in a stable way from one array to the other. Digits that are equal for all
+ * the elements are skipped.
+ *
+ * @param n The length of the array
+ * @param data The array of integers, sorted in place
+ * @param buffer The temporary array, of length n
+ * @param count The count array, of length radix_passes(bits) << bits
+ * @param bits The width of a digit in bits, 8 or 11
+ */
+void radix_sort(int n, int data[], int buffer[], int count[], int bits);
+
+/**
+ * @brief Perform in-place MSD radix sort (American flag sort) on the subarray
+ *
+ * The elements are counted by the digit at position shift, the buckets are computed with a prefix sum and
+ * the elements are moved to their bucket by following the permutation cycles, without an output array.
+ * Then each bucket is sorted recursively on the next digit. Digits that are equal for all the elements are
+ * skipped, and buckets shorter than MSD_THRESHOLD are sorted with network_sort if they are not longer than
+ * SMALL_SORT_THRESHOLD, with insertion sort otherwise.
+ *
+ * @param data The array of integers
+ * @param i The index of the first element
+ * @param j The index of the last element (exclusive)
+ * @param shift The position of the least significant bit of the digit
+ */
+void msd_radix_sort(int data[], int i, int j, int shift = KEY_BITS - MSD_RADIX_BITS);
+
+/**
+ * Execute the sort algorithm
+ * @param n The length of the array
+ * @param data The array of integers
+ * @param arena The buffers of the benchmark
+ * @param msd True to run the MSD radix sort, false for the LSD radix sort
+ * @param bits The width of a digit of the LSD radix sort in bits
+ * @return The execution time in nanoseconds
+ */
+long long benchmark_algorithm(int n, int data[], BenchmarkArena *arena, bool msd, int bits);
+
+/**
+ * Main function to run the sort algorithm
+ * @param argc The number of command-line arguments
+ * @param argv The command-line arguments
+ * @return The exit status
+ */
+int main(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sort.h"
+#include "sort_lib.h"
+#include "utils.h"
+
+// ------------------------ Algorithm Code ------------------------
+
+// Function to get an algorithm by name
+bool parse_algorithm(const std::string &name, SortAlgorithm *algorithm) {
+    if (name == "quick_sort") {
+        *algorithm = QUICK_SORT;
+    } else if (name == "quick_3way_sort") {
+        *algorithm = QUICK_3WAY_SORT;
+    } else if (name == "randomized_quick_sort") {
+        *algorithm = RANDOMIZED_QUICK_SORT;
+    } else if (name == "tim_sort") {
+        *algorithm = TIM_SORT;
+    } else if (name == "merge_sort") {
+        *algorithm = MERGE_SORT;
+    } else if (name == "counting_sort") {
+        *algorithm = COUNTING_SORT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Function to get a mode by name
+bool parse_mode(const std::string &name, RecordMode *mode) {
+    if (name == "records") {
+        *mode = RECORDS_MODE;
+    } else if (name == "index") {
+        *mode = INDEX_MODE;
+    } else if (name == "gather") {
+        *mode = GATHER_MODE;
+    } else if (name == "in_place") {
+        *mode = IN_PLACE_MODE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Function to get the length of the count array of the counting sort
+bool count_length(const int n, const int keys[], int *k) {
+    // The keys may span the whole int range, so the difference is computed on 64 bits
+    long long range = 1;
+    if (n > 0) {
+        range = static_cast<long long>(sort_lib::find_max(n, keys)) - sort_lib::find_min(n, keys) + 1;
+    }
+    if (range > INT_MAX) {
+        return false;
+    }
+    *k = static_cast<int>(range);
+    return true;
+}
+
+// Sort the array with the selected algorithm of sort_lib
+template <class T, class Compare, class KeyFn>
+T *sort_array(const SortAlgorithm algorithm, const int n, T data[], T temp[], int count[], const int k,
+              Compare comp, KeyFn key) {
+    if (algorithm == QUICK_SORT) {
+        sort_lib::quick_sort(data, 0, n, comp);
+    } else if (algorithm == QUICK_3WAY_SORT) {
+        sort_lib::quick_3way_sort(data, 0, n, comp);
+    } else if (algorithm == RANDOMIZED_QUICK_SORT) {
+        sort_lib::randomized_quick_sort(data, 0, n, comp);
+    } else if (algorithm == TIM_SORT) {
+        sort_lib::RunStack run_stack;
+        sort_lib::tim_sort(data, n, temp, &run_stack, comp);
+    } else if (algorithm == MERGE_SORT) {
+        sort_lib::merge_sort(data, n, temp, comp);
+    } else {
+        // The counting sort writes the sorted elements into the second array
+        memset(count, 0, k * sizeof(int));
+        sort_lib::counting_sort(n, k, data, temp, count, key);
+        return temp;
+    }
+    return data;
+}
+
+// ------------------------ Benchmarking Code ------------------------
+
+template <int SIZE>
+long long benchmark_algorithm(const int n, const int keys[], BenchmarkArena *arena, const SortAlgorithm algorithm,
+                              const RecordMode mode) {
+    auto key = [](const Record<SIZE> &record) { return record.key; };
+
+    // Build the records, the payload is only moved around
+    auto *data = arena->get<Record<SIZE>>(RECORD_BUFFER, n);
+    for (int i = 0; i < n; i++) {
+        data[i].key = keys[i];
+        memset(data[i].payload, i & 0xff, sizeof(data[i].payload));
+    }
+    // Only the counting sort needs a count array, the generated keys always fit its range
+    int k = 0;
+    if (algorithm == COUNTING_SORT && !count_length(n, keys, &k)) {
+        throw std::invalid_argument("The range of the keys is too wide for counting_sort");
+    }
+
+    // Reuse the buffers of the arena to avoid the overhead of malloc
+    const int ring_size = copy_ring_size(static_cast<long long>(n) * sizeof(Record<SIZE>));
+    auto *data_copy = arena->get<Record<SIZE>>(COPY_BUFFER, static_cast<long long>(ring_size) * n);
+    auto *temp = arena->get<Record<SIZE>>(TEMP_BUFFER, n);
+    auto *pairs = arena->get<sort_lib::KeyIndex>(PAIRS_BUFFER, n);
+    auto *temp_pairs = arena->get<sort_lib::KeyIndex>(TEMP_PAIRS_BUFFER, n);
+    auto *count = algorithm == COUNTING_SORT ? arena->get<int>(COUNT_BUFFER, k) : nullptr;
+
+    return measure_algorithm(
+            ring_size,
+            [&](const int r) {
+                // Duplicate the input data for the modes that move the records in place
+                if (mode == RECORDS_MODE || mode == IN_PLACE_MODE) {
+                    memcpy(data_copy + static_cast<long long>(r) * n, data, n * sizeof(Record<SIZE>));
+                }
+            },
+            [&](const int r) {
+                Record<SIZE> *records = data_copy + static_cast<long long>(r) * n;
+                if (mode == RECORDS_MODE) {
+                    // Sort the whole records
+                    sort_array(algorithm, n, records, temp, count, k, sort_lib::by_key(key), key);
+                    return;
+                }
+
+                // Sort the (key, index) pairs, the input data is only read
+                sort_lib::make_key_index(n, data, pairs, key);
+                const sort_lib::KeyIndex *sorted = sort_array(algorithm, n, pairs, temp_pairs, count, k,
+                                                              sort_lib::KeyIndexLess(), sort_lib::KeyIndexKey());
+
+                // Move the records to their sorted position
+                if (mode == GATHER_MODE) {
+                    sort_lib::apply_permutation(n, data, sorted, temp);
+                } else if (mode == IN_PLACE_MODE) {
+                    sort_lib::apply_permutation_in_place(n, records, const_cast<sort_lib::KeyIndex *>(sorted));
+                }
+            });
+}
+
+long long benchmark_record_size(const int record_size, const int n, const int keys[], BenchmarkArena *arena,
+                                const SortAlgorithm algorithm, const RecordMode mode) {
+    if (record_size == 16) {
+        return benchmark_algorithm<16>(n, keys, arena, algorithm, mode);
+    }
+    if (record_size == 64) {
+        return benchmark_algorithm<64>(n, keys, arena, algorithm, mode);
+    }
+    if (record_size == 128) {
+        return benchmark_algorithm<128>(n, keys, arena, algorithm, mode);
+    }
+    return benchmark_algorithm<256>(n, keys, arena, algorithm, mode);
+}
+
+// ------------------------ Main Function ------------------------
+
+#ifndef BENCHMARK_MODE
+
+int main(int argc, char *argv[]) {
+    // Read the keys from stdin
+    std::vector<int> data = read_input_data();
+
+    // Convert the vector to an array
+    const int n = data.size();
+    const int *keys = data.data();
+
+    SortAlgorithm algorithm;
+    RecordMode mode;
+    if (!parse_algorithm(get_option(argc, argv, "algorithm", "tim_sort"), &algorithm) ||
+        !parse_mode(get_option(argc, argv, "mode", "gather"), &mode)) {
+        std::cerr << "Unknown algorithm or mode" << std::endl;
+        return 1;
+    }
+
+    // Only the counting sort needs a count array, if the range of the keys fits in one
+    int k = 0;
+    if (algorithm == COUNTING_SORT && !count_length(n, keys, &k)) {
+        std::cerr << "The range of the keys is too wide for counting_sort" << std::endl;
+        return 1;
+    }
+
+    // Build 64-byte records whose payload holds the index of the record
+    auto key = [](const Record<64> &record) { return record.key; };
+    auto *records = new Record<64>[n];
+    auto *temp = new Record<64>[n];
+    auto *pairs = new sort_lib::KeyIndex[n];
+    auto *temp_pairs = new sort_lib::KeyIndex[n];
+    auto *count = algorithm == COUNTING_SORT ? new int[k] : nullptr;
+    for (int i = 0; i < n; i++) {
+        records[i].key = keys[i];
+        memcpy(records[i].payload, &i, sizeof(int));
+    }
+
+    // Execute the sort algorithm
+    const Record<64> *sorted = records;
+    if (mode == RECORDS_MODE) {
+        sorted = sort_array(algorithm, n, records, temp, count, k, sort_lib::by_key(key), key);
+    } else {
+        sort_lib::make_key_index(n, records, pairs, key);
+        sort_lib::KeyIndex *sorted_pairs = sort_array(algorithm, n, pairs, temp_pairs, count, k,
+                                                      sort_lib::KeyIndexLess(), sort_lib::KeyIndexKey());
+        if (mode == IN_PLACE_MODE) {
+            sort_lib::apply_permutation_in_place(n, records, sorted_pairs);
+        } else {
+            sort_lib::apply_permutation(n, records, sorted_pairs, temp);
+            sorted = temp;
+        }
+    }
+
+    // Print the sorted keys
+    for (int i = 0; i < n; i++) {
+        std::cout << sorted[i].key << " ";
+    }
+
+    // Free the allocated memory
+    delete[] records;
+    delete[] temp;
+    delete[] pairs;
+    delete[] temp_pairs;
+    delete[] count;
+
+    return 0;
+}
+
+#else
+
+int main(const int argc, char *argv[]) {
+    set_cpu_affinity();
+
+    const std::vector<std::string> args = get_positional_arguments(argc, argv);
+
+    if (args.size() < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [length|max] [linear|exponential] [output_file]"
+                     " [--algorithm=quick_sort|quick_3way_sort|randomized_quick_sort|tim_sort|merge_sort"
+                     "|counting_sort]"
+                     " [--mode=records|index|gather|in_place] [--record-size=16|64|128|256] [--max-length=N]"
+                     " [--order=random|sorted|reversed|organ_pipe|nearly_sorted|shuffled_runs] [--seed=N]"
+                     " [--huge-pages] [--counters] [--timing=total|sort] [--cores=LIST]"
+                  << std::endl;
+        return 1;
+    }
+
+    // Select the algorithm and what it sorts
+    const std::string algorithm_name = get_option(argc, argv, "algorithm", "tim_sort");
+    SortAlgorithm algorithm;
+    if (!parse_algorithm(algorithm_name, &algorithm)) {
+        std::cerr << "Unknown algorithm: " << algorithm_name << std::endl;
+        return 1;
+    }
+    const std::string mode_name = get_option(argc, argv, "mode", "records");
+    RecordMode record_mode;
+    if (!parse_mode(mode_name, &record_mode)) {
+        std::cerr << "Unknown mode: " << mode_name << std::endl;
+        return 1;
+    }
+    const int record_size = std::stoi(get_option(argc, argv, "record-size", "64"));
+    if (record_size != 16 && record_size != 64 && record_size != 128 && record_size != 256) {
+        std::cerr << "Unsupported record size: " << record_size << std::endl;
+        return 1;
+    }
+
+    // Select the order of the input data
+    const std::string order = get_option(argc, argv, "order", "random");
+    if (!is_valid_input_order(order)) {
+        std::cerr << "Unknown input order: " << order << std::endl;
+        return 1;
+    }
+
+    // Generate the same input data as the other executables run with the same seed
+    const std::string seed = get_option(argc, argv, "seed", "");
+    if (!seed.empty()) {
+        set_input_seed(std::stoul(seed));
+    }
+
+    const std::string mode = args[1];
+    const bool test_length = (mode == "length");
+
+    // Default to exponential scaling if not specified
+    bool linear_scaling = false;
+    if (args.size() >= 3) {
+        const std::string scaling_mode = args[2];
+        linear_scaling = (scaling_mode == "linear");
+    }
+
+    // Output filename
+    std::string output_file;
+    if (args.size() >= 4) {
+        output_file = args[3];
+    } else {
+        // Generate a filename based on test parameters and timestamp
+        std::string sort_type = algorithm_name + "_" + mode_name + "_" + std::to_string(record_size) + "B";
+        if (order != "random") {
+            sort_type += "_" + order;
+        }
+        output_file = generate_filename(test_length ? "length" : "max", linear_scaling, sort_type);
+    }
+
+    std::vector<RunResult> runs;
+
+    // Determine which parameter to vary and its range
+    int min_param, max_param;
+    bool vary_length;
+    if (test_length) {
+        min_param = 100; // min_length
+        max_param = std::stoi(get_option(argc, argv, "max-length", std::to_string(RECORD_MAX_LENGTH))); // max_length
+        vary_length = true;
+    } else {
+        min_param = 10; // min_max
+        max_param = 1000000; // max_max
+        vary_length = false;
+    }
+
+    // Generate sample points based on scaling type
+    std::vector<int> sample_points = generate_sample_points(min_param, max_param, NUM_SAMPLES, linear_scaling);
+
+    // Allocate the buffers once for the largest arrays of records of the sweep
+    BenchmarkArena arena(static_cast<size_t>(vary_length ? max_param : 100000) * record_size,
+                         has_flag(argc, argv, "huge-pages"));
+
+    // Count the hardware events of the timed loops if requested
+    if (has_flag(argc, argv, "counters")) {
+        enable_perf_counters();
+    }
+
+    // Select whether the timed loops measure the copies of the input or only the sorts
+    const std::string timing = get_option(argc, argv, "timing", "total");
+    TimingMode timing_mode;
+    if (!parse_timing_mode(timing, &timing_mode)) {
+        std::cerr << "Unknown timing mode: " << timing << std::endl;
+        return 1;
+    }
+    set_timing_mode(timing_mode);
+
+    // Shard the sample points across worker processes pinned to the given cores, if any
+    const std::string cores_option = get_option(argc, argv, "cores", "");
+    std::vector<int> cores;
+    if (!parse_core_list(cores_option, &cores)) {
+        std::cerr << "Invalid list of cores: " << cores_option << std::endl;
+        return 1;
+    }
+
+    // Run tests for each sample point, sharded across the cores if requested
+    const bool completed = run_sweep(sample_points, cores, &runs, [&](const int param_value) {
+        RunResult run = {};
+
+        if (vary_length) {
+            run.max = 1000000;
+            run.length = param_value;
+        } else {
+            run.max = param_value;
+            run.length = 100000;
+        }
+
+        // Run multiple times for each sample point
+        for (int r = 0; r < NUM_RUNS; r++) {
+            // Generate the keys of the records with appropriate parameters
+            const auto keys = arena.get<int>(INPUT_BUFFER, run.length);
+            generate_input_data(keys, run.length, run.min, run.max);
+            arrange_input_data(keys, run.length, order);
+            // Execute and record time
+            run.time[r] = benchmark_record_size(record_size, run.length, keys, &arena, algorithm, record_mode);
+            add_perf_counters(&run);
+            add_copy_time(&run);
+        }
+
+        // Print results for this run
+        std::cout << "Length: " << run.length << ", Min: " << run.min << ", Max: " << run.max << std::endl;
+
+        return run;
+    });
+    if (!completed) {
+        return 1;
+    }
+
+    // Write results to CSV file
+    write_results_to_csv(output_file, runs);
+
+    return 0;
+}
+
+#endif
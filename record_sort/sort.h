@@ -0,0 +1,127 @@
+#ifndef RECORD_SORT_H
+#define RECORD_SORT_H
+
+#include <string>
+
+#include "arena.h"
+#include "key_index.h"
+
+// Default length of the arrays of the length benchmark; the array of 256-byte records takes 25 MB.
+constexpr int RECORD_MAX_LENGTH = 100000;
+
+/**
+ * @brief Record sorted by the benchmark: an int key followed by a payload that the sorts never read
+ * @tparam SIZE The size of the record in bytes
+ */
+template <int SIZE>
+struct Record {
+    int key; // Key of the record
+    char payload[SIZE - sizeof(int)]; // Rest of the record
+};
+
+/**
+ * @brief Algorithm of sort_lib used by the benchmark
+ */
+enum SortAlgorithm_t {
+    QUICK_SORT,
+    QUICK_3WAY_SORT,
+    RANDOMIZED_QUICK_SORT,
+    TIM_SORT,
+    MERGE_SORT,
+    COUNTING_SORT,
+} typedef SortAlgorithm;
+
+/**
+ * @brief What the benchmark sorts
+ */
+enum RecordMode_t {
+    RECORDS_MODE, // The whole records
+    INDEX_MODE, // The (key, index) pairs of the records: the result is the permutation
+    GATHER_MODE, // The pairs, then the records are gathered into a second array with apply_permutation
+    IN_PLACE_MODE, // The pairs, then the records are moved in place with apply_permutation_in_place
+} typedef RecordMode;
+
+/**
+ * @brief Buffers of the arena used by the benchmark in addition to those of ArenaBuffer
+ */
+enum RecordBuffer_t {
+    RECORD_BUFFER = NUM_ARENA_BUFFERS, // Records built from the keys
+    PAIRS_BUFFER, // (key, index) pairs of the records
+    TEMP_PAIRS_BUFFER, // Temporary array of the pairs
+} typedef RecordBuffer;
+
+/**
+ * @brief Get the algorithm with the given name
+ * @param name "quick_sort", "quick_3way_sort", "randomized_quick_sort", "tim_sort", "merge_sort" or "counting_sort"
+ * @param algorithm The algorithm, set if the name is known
+ * @return true if the name is known
+ */
+bool parse_algorithm(const std::string &name, SortAlgorithm *algorithm);
+
+/**
+ * @brief Get the mode with the given name
+ * @param name "records", "index", "gather" or "in_place"
+ * @param mode The mode, set if the name is known
+ * @return true if the name is known
+ */
+bool parse_mode(const std::string &name, RecordMode *mode);
+
+/**
+ * @brief Get the length of the count array of counting_sort for the given keys
+ * @param n The length of the array
+ * @param keys The keys of the records
+ * @param k The number of distinct keys, max - min + 1, set if it fits in an int (1 for an empty array)
+ * @return true if the range of the keys fits in an int
+ */
+bool count_length(int n, const int keys[], int *k);
+
+/**
+ * @brief Sort the array with the selected algorithm of sort_lib
+ * @param algorithm The algorithm
+ * @param n The length of the array
+ * @param data The array to sort
+ * @param temp The temporary array of tim_sort and merge_sort and the output array of counting_sort, of length n
+ * @param count The count array of counting_sort, of length k (unused by the other algorithms)
+ * @param k The number of distinct keys, max - min + 1
+ * @param comp The comparator of the comparison sorts
+ * @param key The key extractor of counting_sort
+ * @return The sorted array: temp for counting_sort, data for the other algorithms
+ */
+template <class T, class Compare, class KeyFn>
+T *sort_array(SortAlgorithm algorithm, int n, T data[], T temp[], int count[], int k, Compare comp, KeyFn key);
+
+/**
+ * Execute the sort algorithm on records of SIZE bytes
+ * @param n The length of the array
+ * @param keys The keys of the records
+ * @param arena The buffers of the benchmark
+ * @param algorithm The algorithm
+ * @param mode Whether the records or their (key, index) pairs are sorted
+ * @return The execution time in nanoseconds
+ */
+template <int SIZE>
+long long benchmark_algorithm(int n, const int keys[], BenchmarkArena *arena, SortAlgorithm algorithm,
+                              RecordMode mode);
+
+/**
+ * Execute the sort algorithm on records of the given size
+ * @param record_size The size of the records in bytes: 16, 64, 128 or 256
+ * @param n The length of the array
+ * @param keys The keys of the records
+ * @param arena The buffers of the benchmark
+ * @param algorithm The algorithm
+ * @param mode Whether the records or their (key, index) pairs are sorted
+ * @return The execution time in nanoseconds
+ */
+long long benchmark_record_size(int record_size, int n, const int keys[], BenchmarkArena *arena,
+                                SortAlgorithm algorithm, RecordMode mode);
+
+/**
+ * Main function to run the sort algorithm
+ * @param argc The number of command-line arguments
+ * @param argv The command-line arguments
+ * @return The exit status
+ */
+int main(int argc, char *argv[]);
+
+#endif
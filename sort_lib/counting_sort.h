@@ -0,0 +1,318 @@
+#ifndef SORT_LIB_COUNTING_SORT_H
+#define SORT_LIB_COUNTING_SORT_H
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sort_base.h"
+
+namespace sort_lib {
+
+// Width of the key range handled by each sub-histogram of the blocked counting sort, in bits.
+// 2^13 counts take 32 KB, so the counting and the output passes of a block hit the L1/L2 cache.
+constexpr int BLOCKED_RANGE_BITS = 13;
+
+// The counting sorts order the elements by an integer key: key(x) must return an integral type, of any width and
+// signedness, and the keys of the array must span at most 2^31 - 1 values. The offsets key - min are computed in the
+// type of the key, so wide keys are not truncated. The default key is the element itself.
+
+/**
+ * @brief Type of the keys extracted by KeyFn from the elements of type T
+ */
+template <class T, class KeyFn>
+using KeyType = std::decay_t<decltype(std::declval<KeyFn &>()(std::declval<const T &>()))>;
+
+/**
+ * Get the offset of a key from the minimum key, the index of the key in the count array
+ * @param key The key
+ * @param min_val The minimum key, at most key
+ * @return key - min_val
+ */
+template <class K>
+int key_offset(const K key, const K min_val) {
+    static_assert(std::is_integral<K>::value, "The counting sorts need an integral key");
+    return static_cast<int>(key - min_val);
+}
+
+/**
+ * Find the maximum key in the array
+ * @param n The length of the array, at least 1
+ * @param data The array
+ * @param key The key extractor
+ * @return The maximum key in the array
+ */
+template <class T, class KeyFn = Identity>
+KeyType<T, KeyFn> find_max(const int n, const T data[], KeyFn key = KeyFn()) {
+    KeyType<T, KeyFn> max = key(data[0]);
+
+    for (int i = 1; i < n; i++) {
+        if (key(data[i]) > max) {
+            max = key(data[i]);
+        }
+    }
+
+    return max;
+}
+
+/**
+ * Find the minimum key in the array
+ * @param n The length of the array, at least 1
+ * @param data The array
+ * @param key The key extractor
+ * @return The minimum key in the array
+ */
+template <class T, class KeyFn = Identity>
+KeyType<T, KeyFn> find_min(const int n, const T data[], KeyFn key = KeyFn()) {
+    KeyType<T, KeyFn> min = key(data[0]);
+
+    for (int i = 1; i < n; i++) {
+        if (key(data[i]) < min) {
+            min = key(data[i]);
+        }
+    }
+
+    return min;
+}
+
+/**
+ * Perform counting sort on the input array
+ * @param n The length of the array
+ * @param k The length of the count array, max - min + 1
+ * @param data The array to sort
+ * @param out The output array
+ * @param count The count array, initialized to zero
+ * @param key The key extractor
+ */
+template <class T, class KeyFn = Identity>
+void counting_sort(const int n, const int k, const T data[], T out[], int count[], KeyFn key = KeyFn()) {
+    if (n == 0) {
+        return;
+    }
+
+    // Find the minimum key of the array
+    const KeyType<T, KeyFn> min_val = find_min(n, data, key);
+
+    // Count occurrences of each key
+    for (int i = 0; i < n; i++) {
+        count[key_offset(key(data[i]), min_val)]++;
+    }
+
+    // Calculate cumulative count
+    for (int i = 1; i < k; i++) {
+        count[i] += count[i - 1];
+    }
+
+    // Build the output array
+    for (int i = n - 1; i >= 0; i--) {
+        const int offset = key_offset(key(data[i]), min_val);
+        out[count[offset] - 1] = data[i];
+        count[offset]--;
+    }
+}
+
+/**
+ * Get the length of the count array needed by the blocked counting sort
+ * @param k The number of distinct keys, max - min + 1
+ * @return The length of the count array
+ */
+inline int blocked_count_length(const int k) {
+    const int num_blocks = ((k - 1) >> BLOCKED_RANGE_BITS) + 1;
+    return (1 << BLOCKED_RANGE_BITS) + num_blocks;
+}
+
+/**
+ * Perform counting sort on the input array, one cache-sized key range at a time
+ *
+ * When the count array does not fit in the cache, every increment and every output position becomes a cache miss.
+ * This variant first distributes the elements into buffer by the high bits of key - min, so that each block
+ * holds a range of 2^BLOCKED_RANGE_BITS keys, then sorts each block into out with a counting sort whose count
+ * array fits in the cache. Both passes are stable.
+ *
+ * @param n The length of the array
+ * @param k The number of distinct keys, max - min + 1
+ * @param data The array to sort
+ * @param out The output array
+ * @param count The count array, of length blocked_count_length(k) (no initialization needed)
+ * @param buffer The temporary array, of length n
+ * @param key The key extractor
+ */
+template <class T, class KeyFn = Identity>
+void blocked_counting_sort(const int n, const int k, const T data[], T out[], int count[], T buffer[],
+                           KeyFn key = KeyFn()) {
+    constexpr int block_size = 1 << BLOCKED_RANGE_BITS;
+    constexpr int mask = block_size - 1;
+    const int num_blocks = ((k - 1) >> BLOCKED_RANGE_BITS) + 1;
+    if (n == 0) {
+        return;
+    }
+
+    // The count array holds the sub-histogram of a block followed by the
+    // starting position of each block
+    int *sub_count = count;
+    int *block_start = count + block_size;
+
+    // Find the minimum key of the array
+    const KeyType<T, KeyFn> min_val = find_min(n, data, key);
+
+    // A single block already fits in the cache: sort the input directly
+    const T *src = buffer;
+    if (num_blocks == 1) {
+        src = data;
+        block_start[0] = n;
+    } else {
+        // Count the elements of each block
+        memset(block_start, 0, num_blocks * sizeof(int));
+        for (int i = 0; i < n; i++) {
+            block_start[key_offset(key(data[i]), min_val) >> BLOCKED_RANGE_BITS]++;
+        }
+
+        // Calculate the starting position of each block
+        int sum = 0;
+        for (int b = 0; b < num_blocks; b++) {
+            const int c = block_start[b];
+            block_start[b] = sum;
+            sum += c;
+        }
+
+        // Distribute the elements into their block, keeping their relative order.
+        // After this loop, block_start[b] is the end of block b.
+        for (int i = 0; i < n; i++) {
+            buffer[block_start[key_offset(key(data[i]), min_val) >> BLOCKED_RANGE_BITS]++] = data[i];
+        }
+    }
+
+    // Sort each block with a counting sort on the low bits of the key
+    int start = 0;
+    for (int b = 0; b < num_blocks; b++) {
+        const int end = block_start[b];
+        // Number of distinct keys of the block, smaller for the last one
+        const int range = std::min(block_size, k - b * block_size);
+
+        if (end - start > 1) {
+            // Count occurrences of each key of the block
+            memset(sub_count, 0, range * sizeof(int));
+            for (int i = start; i < end; i++) {
+                sub_count[key_offset(key(src[i]), min_val) & mask]++;
+            }
+
+            // Calculate the starting position of each key of the block
+            int position = start;
+            for (int v = 0; v < range; v++) {
+                const int c = sub_count[v];
+                sub_count[v] = position;
+                position += c;
+            }
+
+            // Build the output array
+            for (int i = start; i < end; i++) {
+                out[sub_count[key_offset(key(src[i]), min_val) & mask]++] = src[i];
+            }
+        } else if (end - start == 1) {
+            out[start] = src[start];
+        }
+        start = end;
+    }
+}
+
+/**
+ * Perform counting sort on the input array using all the threads of the pool
+ *
+ * The array is split into one chunk per thread. Each thread counts the elements of its chunk in a private
+ * histogram. The histograms are then merged into per-thread offsets: for every key, the elements of chunk t
+ * are placed after the equal elements of the chunks before it. Finally, each thread scatters its chunk
+ * forward, so the sort stays stable.
+ *
+ * @param n The length of the array
+ * @param k The number of distinct keys, max - min + 1
+ * @param data The array to sort
+ * @param out The output array
+ * @param counts The per-thread count arrays, of length pool->size() * k (no initialization needed)
+ * @param pool The pool that executes the sort
+ * @param key The key extractor
+ */
+template <class T, class Pool, class KeyFn = Identity>
+void parallel_counting_sort(const int n, const int k, const T data[], T out[], int counts[], Pool *pool,
+                            KeyFn key = KeyFn()) {
+    const int num_threads = pool->size();
+    if (n == 0) {
+        return;
+    }
+
+    // Each thread works on the chunk [chunk_start(t), chunk_start(t + 1)) of the
+    // array and on the bucket range [bucket_start(t), bucket_start(t + 1))
+    auto chunk_start = [n, num_threads](const int t) {
+        return static_cast<int>(static_cast<long long>(n) * t / num_threads);
+    };
+    auto bucket_start = [k, num_threads](const int t) {
+        return static_cast<int>(static_cast<long long>(k) * t / num_threads);
+    };
+
+    // Find the minimum key of each chunk, then of the array. Each task keeps its minimum in a local variable and
+    // stores it once, so that the threads do not write to the same cache line in the loop
+    std::vector<KeyType<T, KeyFn>> chunk_min(num_threads, key(data[0]));
+    pool->parallel_for(num_threads, [&](const int t) {
+        KeyType<T, KeyFn> min = key(data[0]);
+        for (int i = chunk_start(t); i < chunk_start(t + 1); i++) {
+            if (key(data[i]) < min) {
+                min = key(data[i]);
+            }
+        }
+        chunk_min[t] = min;
+    });
+    const KeyType<T, KeyFn> min_val = *std::min_element(chunk_min.begin(), chunk_min.end());
+
+    // Count occurrences of each key of the chunk in the private histogram
+    pool->parallel_for(num_threads, [&](const int t) {
+        int *count = counts + static_cast<long long>(t) * k;
+        memset(count, 0, k * sizeof(int));
+        for (int i = chunk_start(t); i < chunk_start(t + 1); i++) {
+            count[key_offset(key(data[i]), min_val)]++;
+        }
+    });
+
+    // Calculate the number of elements in each bucket range
+    std::vector<int> range_start(num_threads + 1, 0);
+    pool->parallel_for(num_threads, [&](const int t) {
+        int sum = 0;
+        for (int v = bucket_start(t); v < bucket_start(t + 1); v++) {
+            for (int s = 0; s < num_threads; s++) {
+                sum += counts[static_cast<long long>(s) * k + v];
+            }
+        }
+        range_start[t + 1] = sum;
+    });
+
+    // Calculate the starting position of each bucket range
+    for (int t = 0; t < num_threads; t++) {
+        range_start[t + 1] += range_start[t];
+    }
+
+    // Replace the counts with the position of the first element of each key
+    // in each chunk: chunk s follows the equal elements of the chunks before it
+    pool->parallel_for(num_threads, [&](const int t) {
+        int position = range_start[t];
+        for (int v = bucket_start(t); v < bucket_start(t + 1); v++) {
+            for (int s = 0; s < num_threads; s++) {
+                int &count = counts[static_cast<long long>(s) * k + v];
+                const int c = count;
+                count = position;
+                position += c;
+            }
+        }
+    });
+
+    // Build the output array, each chunk in order from its own positions
+    pool->parallel_for(num_threads, [&](const int t) {
+        int *position = counts + static_cast<long long>(t) * k;
+        for (int i = chunk_start(t); i < chunk_start(t + 1); i++) {
+            out[position[key_offset(key(data[i]), min_val)]++] = data[i];
+        }
+    });
+}
+
+} // namespace sort_lib
+
+#endif
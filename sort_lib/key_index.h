@@ -0,0 +1,122 @@
+#ifndef SORT_LIB_KEY_INDEX_H
+#define SORT_LIB_KEY_INDEX_H
+
+#include <utility>
+
+namespace sort_lib {
+
+// Number of elements apply_permutation looks ahead when it prefetches the records to gather.
+constexpr int PERMUTATION_PREFETCH_DISTANCE = 8;
+
+/**
+ * @brief Key of a record packed with the index of the record, sorted instead of the record itself
+ *
+ * Sorting 8-byte pairs moves a fraction of the memory moved by sorting records of 64 bytes or more. The sorted
+ * pairs are the permutation of the records: the i-th record of the sorted array is data[pairs[i].index].
+ */
+struct KeyIndex_t {
+    int key; // Key of the record
+    int index; // Index of the record in the unsorted array
+} typedef KeyIndex;
+
+/**
+ * @brief Comparator of the pairs: by key, then by index
+ *
+ * Ties are broken by the index, so every sort orders the pairs like a stable sort of the records, and the quick
+ * sorts never see equal elements.
+ */
+struct KeyIndexLess {
+    bool operator()(const KeyIndex &x, const KeyIndex &y) const {
+        return x.key < y.key || (x.key == y.key && x.index < y.index);
+    }
+};
+
+/**
+ * @brief Key extractor of the pairs for the counting sorts
+ */
+struct KeyIndexKey {
+    int operator()(const KeyIndex &x) const {
+        return x.key;
+    }
+};
+
+/**
+ * @brief Build the (key, index) pairs of the records
+ * @param n The length of the array
+ * @param data The records
+ * @param pairs The output pairs, of length n
+ * @param key The key extractor, returning an int
+ */
+template <class T, class KeyFn>
+void make_key_index(const int n, const T data[], KeyIndex pairs[], KeyFn key) {
+    for (int i = 0; i < n; i++) {
+        pairs[i].key = key(data[i]);
+        pairs[i].index = i;
+    }
+}
+
+/**
+ * @brief Gather the records in the order of the sorted pairs
+ *
+ * The records are written sequentially and read in the order of the permutation; the record needed
+ * PERMUTATION_PREFETCH_DISTANCE steps later is prefetched, so the random reads overlap instead of stalling
+ * one after the other.
+ *
+ * @param n The length of the array
+ * @param data The records, in their unsorted order
+ * @param pairs The sorted pairs of the records
+ * @param out The sorted records, of length n
+ */
+template <class T>
+void apply_permutation(const int n, const T data[], const KeyIndex pairs[], T out[]) {
+    for (int i = 0; i < n; i++) {
+        if (i + PERMUTATION_PREFETCH_DISTANCE < n) {
+            __builtin_prefetch(&data[pairs[i + PERMUTATION_PREFETCH_DISTANCE].index]);
+        }
+        out[i] = data[pairs[i].index];
+    }
+}
+
+/**
+ * @brief Move the records to the order of the sorted pairs without a second array
+ *
+ * Every cycle of the permutation is followed once, moving each record a single time. The indices of the visited
+ * pairs are marked by complementing them, and restored at the end.
+ *
+ * @param n The length of the array
+ * @param data The records, sorted in place
+ * @param pairs The sorted pairs of the records
+ */
+template <class T>
+void apply_permutation_in_place(const int n, T data[], KeyIndex pairs[]) {
+    for (int i = 0; i < n; i++) {
+        if (pairs[i].index < 0 || pairs[i].index == i) {
+            continue; // Already moved, or already in place
+        }
+
+        // Follow the cycle starting at i: position j receives the record at pairs[j].index
+        T temp = std::move(data[i]);
+        int j = i;
+        while (true) {
+            const int k = pairs[j].index;
+            pairs[j].index = ~k;
+            if (k == i) {
+                data[j] = std::move(temp);
+                break;
+            }
+            data[j] = std::move(data[k]);
+            j = k;
+        }
+    }
+
+    // Restore the marked indices
+    for (int i = 0; i < n; i++) {
+        if (pairs[i].index < 0) {
+            pairs[i].index = ~pairs[i].index;
+        }
+    }
+}
+
+} // namespace sort_lib
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef SORT_LIB_MERGE_PATH_H
+#define SORT_LIB_MERGE_PATH_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace sort_lib {
+
+/**
+ * @brief Part of a merge that can be computed independently of the others
+ *
+ * The segment merges a[a_begin:a_end] and b[b_begin:b_end] (ends exclusive) into out[out_begin:],
+ * with out_begin = a_begin + b_begin.
+ */
+struct MergeSegment_t {
+    int a_begin; // First element of the first array
+    int a_end; // Last element of the first array (exclusive)
+    int b_begin; // First element of the second array
+    int b_end; // Last element of the second array (exclusive)
+    int out_begin; // First position of the output
+} typedef MergeSegment;
+
+/**
+ * @brief Find how many elements of the first sorted array are among the first k elements of the stable merge.
+ *
+ * Binary search on the k-th diagonal of the merge path: the result i satisfies a[i - 1] <= b[k - i] and
+ * b[k - i - 1] < a[i], so equal elements of the first array come before the ones of the second array.
+ *
+ * @param k The number of merged elements, in [0, n1 + n2]
+ * @param a The first sorted array
+ * @param n1 The length of the first array
+ * @param b The second sorted array
+ * @param n2 The length of the second array
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @return The number of elements taken from the first array
+ */
+template <class T, class Compare = std::less<>>
+int co_rank(const int k, const T a[], const int n1, const T b[], const int n2, Compare comp = Compare()) {
+    int lo = k > n2 ? k - n2 : 0;
+    int hi = k < n1 ? k : n1;
+
+    // Find the smallest i such that a[i] comes after b[k - i - 1] in the merge
+    while (lo < hi) {
+        const int i = lo + (hi - lo) / 2;
+        if (comp(b[k - i - 1], a[i])) {
+            hi = i;
+        } else {
+            lo = i + 1;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Split the merge of two sorted arrays into segments of the same output length
+ * @param a The first sorted array
+ * @param n1 The length of the first array
+ * @param b The second sorted array
+ * @param n2 The length of the second array
+ * @param segments The number of segments
+ * @param out The segments, with room for segments elements
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <class T, class Compare = std::less<>>
+void merge_path_split(const T a[], const int n1, const T b[], const int n2, const int segments, MergeSegment out[],
+                      Compare comp = Compare()) {
+    const int total = n1 + n2;
+
+    // The end of a segment is the beginning of the next one
+    int k_begin = 0;
+    int i_begin = 0;
+    for (int s = 0; s < segments; s++) {
+        const int k_end = static_cast<int>(static_cast<long long>(total) * (s + 1) / segments);
+        const int i_end = co_rank(k_end, a, n1, b, n2, comp);
+
+        out[s].a_begin = i_begin;
+        out[s].a_end = i_end;
+        out[s].b_begin = k_begin - i_begin;
+        out[s].b_end = k_end - i_end;
+        out[s].out_begin = k_begin;
+
+        k_begin = k_end;
+        i_begin = i_end;
+    }
+}
+
+/**
+ * @brief Merge a segment of two sorted arrays into the output array
+ *
+ * The merge is stable: equal elements of the first array come before the ones of the second array.
+ *
+ * @param a The first sorted array
+ * @param b The second sorted array
+ * @param segment The segment to merge
+ * @param out The output array of the whole merge
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <class T, class Compare = std::less<>>
+void merge_segment(const T a[], const T b[], const MergeSegment &segment, T out[], Compare comp = Compare()) {
+    int i = segment.a_begin;
+    int j = segment.b_begin;
+    int k = segment.out_begin;
+
+    while (i < segment.a_end && j < segment.b_end) {
+        if (!comp(b[j], a[i])) {
+            out[k++] = a[i++];
+        } else {
+            out[k++] = b[j++];
+        }
+    }
+
+    // Copy the rest of the segment of the array that is not exhausted
+    std::copy(&a[i], &a[segment.a_end], &out[k]);
+    k += segment.a_end - i;
+    std::copy(&b[j], &b[segment.b_end], &out[k]);
+}
+
+/**
+ * @brief Merge two sorted arrays into the output array on the pool
+ *
+ * The merge is split with merge_path_split and every segment is merged by merge_segment on its own task.
+ * The output must not overlap the input arrays.
+ *
+ * @param a The first sorted array
+ * @param n1 The length of the first array
+ * @param b The second sorted array
+ * @param n2 The length of the second array
+ * @param out The output array, with room for n1 + n2 elements
+ * @param pool The pool that executes the segments
+ * @param segments The number of segments
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <class T, class Pool, class Compare = std::less<>>
+void merge_path_merge(const T a[], const int n1, const T b[], const int n2, T out[], Pool *pool, const int segments,
+                      Compare comp = Compare()) {
+    std::vector<MergeSegment> split(segments);
+    merge_path_split(a, n1, b, n2, segments, split.data(), comp);
+
+    pool->parallel_for(segments, [&](const int s) { merge_segment(a, b, split[s], out, comp); });
+}
+
+} // namespace sort_lib
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef SORT_LIB_MERGE_SORT_H
+#define SORT_LIB_MERGE_SORT_H
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "sort_base.h"
+
+namespace sort_lib {
+
+// Length of the runs sorted with insertion sort before the first merge pass.
+constexpr int MERGE_SORT_RUN_LENGTH = 32;
+
+// Maximum number of runs merged at once by multiway_merge.
+constexpr int MERGE_SORT_MAX_WAYS = 8;
+
+// Elements of at least this size are merged MERGE_SORT_MAX_WAYS runs at once by default: moving them costs more
+// than the matches of the loser tree, so fewer passes pay off. Smaller elements are merged two runs at once.
+constexpr int MERGE_SORT_WIDE_ELEMENT_SIZE = 128;
+
+/**
+ * @brief Merge two sorted runs into out
+ *
+ * The next element is selected with a conditional move instead of a branch, so the merge of random runs does not
+ * mispredict. On equal elements the element of the first run goes first, so the merge is stable.
+ *
+ * @param first The first element of the first run
+ * @param first_end The element after the first run
+ * @param second The first element of the second run
+ * @param second_end The element after the second run
+ * @param out The destination of the merged run
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @return T* The element after the merged run
+ */
+template <class T, class Compare>
+T *merge_2way(const T *first, const T *first_end, const T *second, const T *second_end, T *out, Compare comp) {
+    while (first != first_end && second != second_end) {
+        const bool take_second = comp(*second, *first);
+        *out++ = take_second ? *second : *first;
+        second += take_second;
+        first += !take_second;
+    }
+    out = std::copy(first, first_end, out);
+    return std::copy(second, second_end, out);
+}
+
+/**
+ * @brief Merge up to MERGE_SORT_MAX_WAYS consecutive sorted runs of src into dst with a loser tree
+ *
+ * Every internal node of the tree keeps the run that lost the match between its two subtrees, so replacing the
+ * winner costs one comparison per level, log2(runs) in total, instead of runs - 1 for a linear scan. The run with
+ * the lower index wins between equal elements, so the merge is stable.
+ * The tree only holds runs that are not exhausted, so the matches never check the ends of the runs: when the run of
+ * the winner is exhausted, the tree is rebuilt without it. The last two runs are merged with merge_2way.
+ *
+ * @param src The array holding the runs
+ * @param dst The array receiving the merged run, at the same indices
+ * @param bounds The bounds of the runs: run r is src[bounds[r]:bounds[r + 1]]
+ * @param num_runs The number of runs, at most MERGE_SORT_MAX_WAYS
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <class T, class Compare>
+void multiway_merge(const T *src, T *dst, const int *bounds, const int num_runs, Compare comp) {
+    const T *cur[MERGE_SORT_MAX_WAYS]; // Next element of every remaining run, in the order of the runs
+    const T *end[MERGE_SORT_MAX_WAYS]; // End of every remaining run
+    int m = 0; // Number of remaining runs
+    for (int r = 0; r < num_runs; r++) {
+        if (bounds[r] < bounds[r + 1]) {
+            cur[m] = src + bounds[r];
+            end[m] = src + bounds[r + 1];
+            m++;
+        }
+    }
+
+    T *out = dst + bounds[0];
+    while (m > 2) {
+        // Leaves from m to the next power of 2 hold no run and lose every match. They point to an element of the
+        // first run, so that the matches can read their element without a branch.
+        int leaves = 1;
+        while (leaves < m) {
+            leaves <<= 1;
+        }
+        for (int r = m; r < leaves; r++) {
+            cur[r] = cur[0];
+        }
+        // Whether the next element of run x goes before the next element of run y, without branches
+        const auto beats = [&](const int x, const int y) {
+            // Between equal elements the lower run wins: compare them in the order that makes a tie a loss for x
+            const bool x_lower = x < y;
+            const bool ordered = comp(*cur[x_lower ? y : x], *cur[x_lower ? x : y]);
+            return (y >= m) | ((x < m) & (ordered ^ x_lower));
+        };
+
+        // Build the tree bottom-up: node k has the children 2k and 2k + 1, the leaf of run r is leaves + r
+        int winner[2 * MERGE_SORT_MAX_WAYS];
+        int loser[MERGE_SORT_MAX_WAYS];
+        for (int r = 0; r < leaves; r++) {
+            winner[leaves + r] = r;
+        }
+        for (int node = leaves - 1; node >= 1; node--) {
+            const int x = winner[2 * node], y = winner[2 * node + 1];
+            const bool x_wins = beats(x, y);
+            winner[node] = x_wins ? x : y;
+            loser[node] = x_wins ? y : x;
+        }
+        int top = winner[1];
+
+        // Only the run of the winner can be exhausted by an output
+        while (true) {
+            *out++ = *cur[top]++;
+            if (cur[top] == end[top]) {
+                break;
+            }
+            // Replay the matches on the path from the leaf of the winner to the root
+            for (int node = (leaves + top) >> 1; node >= 1; node >>= 1) {
+                const int challenger = loser[node];
+                const bool challenger_wins = beats(challenger, top);
+                loser[node] = challenger_wins ? top : challenger;
+                top = challenger_wins ? challenger : top;
+            }
+        }
+
+        // Remove the exhausted run, keeping the order of the others
+        for (int r = top; r < m - 1; r++) {
+            cur[r] = cur[r + 1];
+            end[r] = end[r + 1];
+        }
+        m--;
+    }
+
+    if (m == 2) {
+        merge_2way(cur[0], end[0], cur[1], end[1], out, comp);
+    } else if (m == 1) {
+        std::copy(cur[0], end[0], out);
+    }
+}
+
+/**
+ * @brief Stable bottom-up merge sort that alternates between arr and temp_arr
+ *
+ * The array is cut into runs of MERGE_SORT_RUN_LENGTH elements sorted with insertion sort, then every pass
+ * merges groups of `ways` consecutive runs from one buffer into the other, so each pass reads and writes every
+ * element exactly once, and `ways` runs are merged per pass to need log_ways(n / MERGE_SORT_RUN_LENGTH) passes.
+ * When the number of passes is odd the runs are sorted in temp_arr, so that the last pass writes into arr.
+ *
+ * @param arr The array to sort
+ * @param n The length of the array
+ * @param temp_arr The temporary array, of at least n elements
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @param ways The number of runs merged at once: 2, 4 or 8
+ */
+template <class T, class Compare = std::less<>>
+void merge_sort(T arr[], const int n, T *temp_arr, Compare comp = Compare(),
+                const int ways = sizeof(T) >= MERGE_SORT_WIDE_ELEMENT_SIZE ? MERGE_SORT_MAX_WAYS : 2) {
+    // Count the passes to choose the buffer of the runs
+    int passes = 0;
+    for (long long width = MERGE_SORT_RUN_LENGTH; width < n; width *= ways) {
+        passes++;
+    }
+
+    T *src = arr, *dst = temp_arr;
+    if (passes % 2 == 1) {
+        std::swap(src, dst);
+        std::copy(arr, arr + n, src);
+    }
+
+    // Sort the initial runs
+    for (int left = 0; left < n; left += MERGE_SORT_RUN_LENGTH) {
+        insertion_sort(src, left, std::min(left + MERGE_SORT_RUN_LENGTH, n) - 1, comp);
+    }
+
+    // Merge groups of runs, alternating between the two buffers
+    int bounds[MERGE_SORT_MAX_WAYS + 1];
+    for (long long width = MERGE_SORT_RUN_LENGTH; width < n; width *= ways) {
+        for (long long left = 0; left < n; left += width * ways) {
+            int num_runs = 0;
+            bounds[0] = static_cast<int>(left);
+            while (num_runs < ways && bounds[num_runs] < n) {
+                bounds[num_runs + 1] = static_cast<int>(std::min(bounds[num_runs] + width, static_cast<long long>(n)));
+                num_runs++;
+            }
+
+            if (num_runs == 1) {
+                std::copy(src + bounds[0], src + bounds[1], dst + bounds[0]);
+            } else if (num_runs == 2) {
+                merge_2way(src + bounds[0], src + bounds[1], src + bounds[1], src + bounds[2], dst + bounds[0], comp);
+            } else {
+                multiway_merge(src, dst, bounds, num_runs, comp);
+            }
+        }
+        std::swap(src, dst);
+    }
+}
+
+} // namespace sort_lib
+
+#endif
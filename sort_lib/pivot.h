@@ -0,0 +1,218 @@
+#ifndef SORT_LIB_PIVOT_H
+#define SORT_LIB_PIVOT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "random.h"
+#include "sort_base.h"
+
+namespace sort_lib {
+
+// Subarrays longer than this choose the pivot with Tukey's ninther instead of the median of 3.
+constexpr int PIVOT_NINTHER_THRESHOLD = 128;
+
+// Number of elements of the groups whose medians are selected by the median of medians.
+constexpr int MEDIAN_GROUP_SIZE = 5;
+
+// A pivot policy is any callable with the same signature as the operator() of the policies of this file: it returns
+// the index in [i, j) of the element of a[i:j] (j exclusive) used as the pivot, and may rearrange the subarray.
+// The quick sorts move this element to a[j - 1] before calling their partition.
+// The policy is passed by pointer to the recursive calls, so a policy with a state (RandomPivot) keeps one
+// state for the whole sort.
+
+/**
+ * @brief Get the index of the median of three elements
+ * @param a Pointer to the array.
+ * @param x Index of the first element.
+ * @param y Index of the second element.
+ * @param z Index of the third element.
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ * @return int The index of the median of a[x], a[y] and a[z].
+ */
+template <class T, class Compare>
+int median_of_3(const T *a, const int x, const int y, const int z, Compare comp) {
+    if (comp(a[x], a[y])) {
+        if (comp(a[y], a[z])) {
+            return y; // a[x] < a[y] < a[z]
+        }
+        return comp(a[x], a[z]) ? z : x;
+    }
+    if (comp(a[x], a[z])) {
+        return x; // a[y] <= a[x] < a[z]
+    }
+    return comp(a[y], a[z]) ? z : y;
+}
+
+/**
+ * @brief Pivot policy that uses the last element, the pivot of the partitions of this library
+ */
+struct LastPivot {
+    template <class T, class Compare>
+    int operator()(T *, int, const int j, Compare) const {
+        return j - 1;
+    }
+};
+
+/**
+ * @brief Pivot policy that uses a random element
+ * @tparam Random The random generator, see random.h
+ */
+template <class Random = WyRand>
+struct RandomPivot {
+    Random rng; // Random generator of the sort
+
+    explicit RandomPivot(const uint64_t seed = DEFAULT_RANDOM_SEED) : rng(seed) {}
+
+    template <class T, class Compare>
+    int operator()(T *, const int i, const int j, Compare) {
+        return random_between(i, j - 1, &rng);
+    }
+};
+
+/**
+ * @brief Pivot policy that uses the median of the first, middle and last element
+ *
+ * Sorted and reversed subarrays are split in halves instead of leaving an empty side.
+ */
+struct MedianOf3Pivot {
+    template <class T, class Compare>
+    int operator()(T *a, const int i, const int j, Compare comp) const {
+        return median_of_3(a, i, i + (j - i) / 2, j - 1, comp);
+    }
+};
+
+/**
+ * @brief Pivot policy that uses Tukey's ninther: the median of the medians of three groups of three elements
+ *
+ * The ninther is closer to the true median than the median of 3 and resists the organ-pipe inputs that defeat it.
+ * Subarrays up to PIVOT_NINTHER_THRESHOLD elements use the median of 3.
+ */
+struct NintherPivot {
+    template <class T, class Compare>
+    int operator()(T *a, const int i, const int j, Compare comp) const {
+        const int n = j - i;
+        const int mid = i + n / 2;
+        if (n <= PIVOT_NINTHER_THRESHOLD) {
+            return median_of_3(a, i, mid, j - 1, comp);
+        }
+
+        const int step = n / 8;
+        const int x = median_of_3(a, i, i + step, i + 2 * step, comp);
+        const int y = median_of_3(a, mid - step, mid, mid + step, comp);
+        const int z = median_of_3(a, j - 1 - 2 * step, j - 1 - step, j - 1, comp);
+        return median_of_3(a, x, y, z, comp);
+    }
+};
+
+template <class T, class Compare>
+int select_kth(T *a, int i, int j, int k, Compare comp);
+
+/**
+ * @brief Get the index of the median of medians of a[i:j] (j exclusive)
+ *
+ * The subarray is cut into groups of MEDIAN_GROUP_SIZE elements, the median of every group is moved to the
+ * front, and the median of these medians is selected with select_kth. It is greater than about 30% of the
+ * elements and less than about 30% of them, so a quick sort using it makes O(log n) levels of partitions.
+ *
+ * @param a Pointer to the array, rearranged by the call.
+ * @param i Starting index of the subarray.
+ * @param j Ending index of the subarray (exclusive).
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ * @return int The index of the median of medians.
+ */
+template <class T, class Compare>
+int median_of_medians(T *a, const int i, const int j, Compare comp) {
+    if (j - i <= MEDIAN_GROUP_SIZE) {
+        insertion_sort(a, i, j - 1, comp);
+        return i + (j - i - 1) / 2;
+    }
+
+    // Move the median of every group to a[i:m]
+    int m = i;
+    for (int g = i; g < j; g += MEDIAN_GROUP_SIZE) {
+        const int end = std::min(g + MEDIAN_GROUP_SIZE, j);
+        insertion_sort(a, g, end - 1, comp);
+        std::swap(a[m++], a[g + (end - g - 1) / 2]);
+    }
+
+    return select_kth(a, i, m, i + (m - i - 1) / 2, comp);
+}
+
+/**
+ * @brief Select the element that goes at index k of the sorted subarray a[i:j] (j exclusive)
+ *
+ * Partitions the subarray into three parts around the median of medians and keeps the part that contains k,
+ * in O(n) time in the worst case.
+ *
+ * @param a Pointer to the array, rearranged by the call.
+ * @param i Starting index of the subarray.
+ * @param j Ending index of the subarray (exclusive).
+ * @param k Index of the element to select, in [i, j).
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ * @return int The index k, holding the selected element.
+ */
+template <class T, class Compare>
+int select_kth(T *a, int i, int j, const int k, Compare comp) {
+    while (j - i > 1) {
+        const T pivot = a[median_of_medians(a, i, j, comp)];
+
+        // [i, lt) goes before the pivot, [lt, gt) is equivalent to it and [gt, j) goes after it
+        int lt = i, gt = j, l = i;
+        while (l < gt) {
+            if (comp(a[l], pivot)) {
+                std::swap(a[lt++], a[l++]);
+            } else if (comp(pivot, a[l])) {
+                std::swap(a[l], a[--gt]);
+            } else {
+                l++;
+            }
+        }
+
+        if (k < lt) {
+            j = lt;
+        } else if (k >= gt) {
+            i = gt;
+        } else {
+            return k;
+        }
+    }
+    return k;
+}
+
+/**
+ * @brief Pivot policy that uses the median of medians
+ *
+ * At least 30% of the subarray is not less than the pivot and 30% not greater, so the 3-way partition of
+ * quick_3way_sort, which sets the keys equal to the pivot aside, runs in O(n log n) time in the worst case. With the
+ * two-way partitions of quick_sort the bound only holds for distinct keys: the keys equal to the pivot all go to one
+ * side, so runs of equal keys still take quadratic time. Selecting the pivot costs a linear pass over the subarray,
+ * so it is slower than the other policies on random inputs.
+ */
+struct MedianOfMediansPivot {
+    template <class T, class Compare>
+    int operator()(T *a, const int i, const int j, Compare comp) const {
+        return median_of_medians(a, i, j, comp);
+    }
+};
+
+/**
+ * @brief Move the pivot chosen by the policy to the end of the subarray, where the partitions expect it
+ * @param a Pointer to the array.
+ * @param i Starting index of the subarray.
+ * @param j Ending index of the subarray (exclusive).
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ * @param pivot_fn The pivot policy.
+ */
+template <class T, class Compare, class Pivot>
+void move_pivot_to_end(T *a, const int i, const int j, Compare comp, Pivot *pivot_fn) {
+    const int p = (*pivot_fn)(a, i, j, comp);
+    if (p != j - 1) {
+        std::swap(a[p], a[j - 1]);
+    }
+}
+
+} // namespace sort_lib
+
+#endif
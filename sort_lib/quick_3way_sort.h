@@ -0,0 +1,287 @@
+#ifndef SORT_LIB_QUICK_3WAY_SORT_H
+#define SORT_LIB_QUICK_3WAY_SORT_H
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "pivot.h"
+#include "sorting_network.h"
+
+namespace sort_lib {
+
+/**
+ * @brief Partitions the array into three parts for the 3-way quick sort.
+ *
+ * This function partitions the subarray a[i...j-1] into three parts:
+ * - Elements that go before the pivot.
+ * - Elements equivalent to the pivot.
+ * - Elements that go after the pivot.
+ *
+ * The pivot is chosen as the last element of the subarray (a[j-1]). It rearranges
+ * the elements so that [i, k) contains elements less than the pivot, [k, l) contains
+ * elements equal to the pivot, and [l, j) contains elements greater than the pivot.
+ *
+ * @param a Pointer to the array.
+ * @param i Starting index of the subarray.
+ * @param j One past the last index of the subarray.
+ * @param k Pointer to store the starting index of the equal-to-pivot region.
+ * @param l Pointer to store the ending index (exclusive) of the equal-to-pivot region.
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ */
+template <class T, class Compare = std::less<>>
+void partition_3way(T *a, const int i, const int j, int *k, int *l, Compare comp = Compare()) {
+    const T pivot = a[j - 1]; // Choose the last element as the pivot
+    int p1 = i, p2 = i, p3 = i;
+
+    while (p3 < j) {
+        if (comp(a[p3], pivot)) { // Case 1: Current element is less than the pivot
+            std::swap(a[p3], a[p2]); // Move current element to the <= pivot region
+            std::swap(a[p2], a[p1]); // Move boundary for < pivot
+            p1++;
+            p2++;
+            p3++;
+        } else if (!comp(pivot, a[p3])) { // Case 2: Current element is equal to the pivot
+            std::swap(a[p3], a[p2]); // Move current element to the <= pivot region
+            p2++;
+            p3++;
+        } else { // Case 3: Current element is greater than the pivot
+            p3++; // Simply move to the next element
+        }
+    }
+
+    // After the loop:
+    // - Elements in range [i, p1) are < pivot
+    // - Elements in range [p1, p2) are == pivot
+    // - Elements in range [p2, j) are > pivot
+
+    *k = p1; // Set `k` to the start of the == pivot region
+    *l = p2; // Set `l` to the end of the == pivot region
+}
+
+/**
+ * @brief Default partition of the 3-way quick sort
+ *
+ * A 3-way partition is any callable with the same signature as operator(), that uses a[j - 1] as the pivot.
+ */
+struct Partition3Way {
+    template <class T, class Compare>
+    void operator()(T *a, const int i, const int j, int *k, int *l, Compare comp) const {
+        partition_3way(a, i, j, k, l, comp);
+    }
+};
+
+/**
+ * @brief Partitions the array into three parts with the Bentley-McIlroy fat partition.
+ *
+ * Same result as partition_3way, with the pivot a[j-1]. The subarray is scanned from both ends like a Hoare
+ * partition, so an element that is already on the correct side is never moved. The elements equal to the pivot met
+ * by the scans are swapped to the two ends of the subarray, and moved to the middle once the scans have met:
+ * keys with few duplicates cost about one swap per misplaced pair, instead of up to two swaps per element less than
+ * the pivot.
+ *
+ * @param a Pointer to the array.
+ * @param i Starting index of the subarray.
+ * @param j One past the last index of the subarray.
+ * @param k Pointer to store the starting index of the equal-to-pivot region.
+ * @param l Pointer to store the ending index (exclusive) of the equal-to-pivot region.
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ */
+template <class T, class Compare = std::less<>>
+void partition_bentley_mcilroy(T *a, const int i, const int j, int *k, int *l, Compare comp = Compare()) {
+    // Move the pivot to the front, where it starts the block of the elements equal to it
+    std::swap(a[i], a[j - 1]);
+    const T pivot = a[i];
+
+    // During the scans: [i, p) == pivot, [p, left) < pivot, (right, q] > pivot, (q, j) == pivot
+    int p = i + 1, left = i + 1;
+    int right = j - 1, q = j - 1;
+    while (true) {
+        // Skip the elements less than the pivot, with a single comparison each
+        while (left <= right) {
+            if (comp(a[left], pivot)) {
+                left++;
+            } else if (!comp(pivot, a[left])) {
+                std::swap(a[p++], a[left++]); // Equal to the pivot: move it to the left end
+            } else {
+                break;
+            }
+        }
+        // Skip the elements greater than the pivot
+        while (left <= right) {
+            if (comp(pivot, a[right])) {
+                right--;
+            } else if (!comp(a[right], pivot)) {
+                std::swap(a[right--], a[q--]); // Equal to the pivot: move it to the right end
+            } else {
+                break;
+            }
+        }
+        if (left > right) {
+            break;
+        }
+        std::swap(a[left++], a[right--]);
+    }
+
+    // Swap the blocks of equal elements from the ends to the middle
+    const int num_less = left - p, num_greater = q - right;
+    int length = std::min(p - i, num_less); // Only the shorter block needs to move
+    std::swap_ranges(a + i, a + i + length, a + left - length);
+    length = std::min(num_greater, j - 1 - q);
+    std::swap_ranges(a + left, a + left + length, a + j - length);
+
+    *k = i + num_less; // Set `k` to the start of the == pivot region
+    *l = j - num_greater; // Set `l` to the end of the == pivot region
+}
+
+/**
+ * @brief Bentley-McIlroy 3-way partition of the 3-way quick sort
+ */
+struct BentleyMcIlroyPartition {
+    template <class T, class Compare>
+    void operator()(T *a, const int i, const int j, int *k, int *l, Compare comp) const {
+        partition_bentley_mcilroy(a, i, j, k, l, comp);
+    }
+};
+
+/**
+ * @brief Main loop of the 3-way quick sort, choosing the pivots with the given policy
+ *
+ * Recurses into the smaller of the < pivot and > pivot regions and loops on the larger one, so at most
+ * O(log n) frames are on the stack. Subarrays up to SMALL_SORT_THRESHOLD elements are sorted with network_sort.
+ *
+ * @param a Pointer to the array.
+ * @param i The starting index of the subarray.
+ * @param j One past the last index of the subarray.
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ * @param partition_fn The 3-way partition used to split the subarrays.
+ * @param pivot_fn The pivot policy, shared by all the calls of the sort.
+ */
+template <class T, class Compare, class Partition, class Pivot>
+void quick_3way_sort_loop(T *a, int i, int j, Compare comp, Partition partition_fn, Pivot *pivot_fn) {
+    // Loop until the subarray is small
+    while (j - i > SMALL_SORT_THRESHOLD) {
+        int k, l;
+        // Partition the array into three parts
+        move_pivot_to_end(a, i, j, comp, pivot_fn);
+        partition_fn(a, i, j, &k, &l, comp);
+
+        // Sort the smaller of the < pivot and > pivot regions and keep looping on the larger one
+        if (k - i < j - l) {
+            quick_3way_sort_loop(a, i, k, comp, partition_fn, pivot_fn);
+            i = l;
+        } else {
+            quick_3way_sort_loop(a, l, j, comp, partition_fn, pivot_fn);
+            j = k;
+        }
+    }
+
+    // Base case: small subarray
+    network_sort(a, i, j, comp);
+}
+
+/**
+ * @brief 3-way QuickSort function.
+ * @param a Pointer to the array.
+ * @param i The starting index of the subarray.
+ * @param j One past the last index of the subarray.
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ * @param partition_fn The 3-way partition used to split the subarrays.
+ * @param pivot_fn The pivot policy, the last element by default (see pivot.h).
+ */
+template <class T, class Compare = std::less<>, class Partition = Partition3Way, class Pivot = LastPivot>
+void quick_3way_sort(T *a, const int i, const int j, Compare comp = Compare(), Partition partition_fn = Partition(),
+                     Pivot pivot_fn = Pivot()) {
+    quick_3way_sort_loop(a, i, j, comp, partition_fn, &pivot_fn);
+}
+
+/**
+ * @brief Dual-pivot QuickSort function (Yaroslavskiy)
+ *
+ * The elements at one third and two thirds of the subarray are moved to its ends and used as the pivots p <= q.
+ * A single scan splits the subarray into the elements less than p, the elements between p and q and the elements
+ * not less than q, so every level of the recursion reads the elements once for three subarrays instead of two.
+ * When p and q are equal, the subarray is split with partition_3way instead, and the keys equal to the pivot are
+ * never sorted again. The sort loops on the largest part, so at most O(log n) frames are on the stack.
+ * Subarrays up to SMALL_SORT_THRESHOLD elements are sorted with network_sort.
+ *
+ * @param a Pointer to the array.
+ * @param i The starting index of the subarray.
+ * @param j One past the last index of the subarray.
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ */
+template <class T, class Compare = std::less<>>
+void dual_pivot_quick_sort(T *a, int i, int j, Compare comp = Compare()) {
+    // Loop until the subarray is small
+    while (j - i > SMALL_SORT_THRESHOLD) {
+        // Choose the pivots at the tertiles, so that sorted inputs are split evenly
+        const int third = (j - i) / 3;
+        std::swap(a[i], a[i + third]);
+        std::swap(a[j - 1], a[j - 1 - third]);
+        if (comp(a[j - 1], a[i])) {
+            std::swap(a[i], a[j - 1]);
+        }
+
+        // Equal pivots: split the elements equal to them from the others
+        if (!comp(a[i], a[j - 1])) {
+            int k, l;
+            partition_3way(a, i, j, &k, &l, comp);
+            if (k - i < j - l) {
+                dual_pivot_quick_sort(a, i, k, comp);
+                i = l;
+            } else {
+                dual_pivot_quick_sort(a, l, j, comp);
+                j = k;
+            }
+            continue;
+        }
+
+        const T p = a[i], q = a[j - 1];
+        int lt = i + 1; // a[i+1:lt] < p
+        int gt = j - 2; // a[gt+1:j-1] >= q
+        for (int m = lt; m <= gt; m++) {
+            if (comp(a[m], p)) {
+                std::swap(a[m], a[lt++]);
+            } else if (!comp(a[m], q)) {
+                // Skip the elements of the right end that are already greater than q
+                while (m < gt && comp(q, a[gt])) {
+                    gt--;
+                }
+                std::swap(a[m], a[gt--]);
+                if (comp(a[m], p)) {
+                    std::swap(a[m], a[lt++]);
+                }
+            }
+        }
+
+        // Move the pivots to their final position
+        lt--;
+        gt++;
+        std::swap(a[i], a[lt]);
+        std::swap(a[j - 1], a[gt]);
+
+        // Sort the two smaller parts and keep looping on the largest one
+        const int size_left = lt - i, size_middle = gt - lt - 1, size_right = j - gt - 1;
+        if (size_left >= size_middle && size_left >= size_right) {
+            dual_pivot_quick_sort(a, lt + 1, gt, comp);
+            dual_pivot_quick_sort(a, gt + 1, j, comp);
+            j = lt;
+        } else if (size_middle >= size_right) {
+            dual_pivot_quick_sort(a, i, lt, comp);
+            dual_pivot_quick_sort(a, gt + 1, j, comp);
+            i = lt + 1;
+            j = gt;
+        } else {
+            dual_pivot_quick_sort(a, i, lt, comp);
+            dual_pivot_quick_sort(a, lt + 1, gt, comp);
+            i = gt + 1;
+        }
+    }
+
+    // Base case: small subarray
+    network_sort(a, i, j, comp);
+}
+
+} // namespace sort_lib
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef SORT_LIB_QUICK_SORT_H
+#define SORT_LIB_QUICK_SORT_H
+
+#include <functional>
+#include <utility>
+
+#include "pivot.h"
+#include "sort_base.h"
+#include "sorting_network.h"
+
+namespace sort_lib {
+
+// Subarrays of the introsort up to this length are sorted with insertion sort, or with network_sort when they
+// are not longer than SMALL_SORT_THRESHOLD.
+constexpr int INTRO_THRESHOLD = 16;
+
+/**
+ * @brief Partitions the array
+ *
+ * This function rearranges elements in the subarray such that all elements that do not go after
+ * the pivot are placed to its left and all the others to its right.
+ * The pivot is chosen as the last element of the subarray.
+ *
+ * @param a Pointer to the array.
+ * @param i Starting index of the subarray.
+ * @param j Ending index of the subarray (exclusive).
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ * @return int The final index position of the pivot after partitioning.
+ */
+template <class T, class Compare = std::less<>>
+int partition(T *a, const int i, const int j, Compare comp = Compare()) {
+    int k = i; // index of the pivot's final position after the partition function
+    const T pivot = a[j - 1]; // Choose the last element as the pivot
+
+    for (int l = i; l < j; l++) { // Exclude pivot from comparisons
+        if (!comp(pivot, a[l])) {
+            std::swap(a[k], a[l]); // Place smaller elements on the left
+            k++;
+        }
+    }
+    return k - 1; // Return the pivot's final position
+}
+
+/**
+ * @brief Default partition of the quick sorts: the Lomuto partition
+ *
+ * A partition is any callable with the same signature as operator(), that uses a[j - 1] as the pivot and
+ * returns its final index.
+ */
+struct LomutoPartition {
+    template <class T, class Compare>
+    int operator()(T *a, const int i, const int j, Compare comp) const {
+        return partition(a, i, j, comp);
+    }
+};
+
+/**
+ * @brief Main loop of the quick sort, choosing the pivots with the given policy
+ *
+ * Recurses into the smaller partition and loops on the larger one, so at most O(log n) frames are on the stack
+ * even when every partition is unbalanced (sorted input with the last pivot). Subarrays up to
+ * SMALL_SORT_THRESHOLD elements are sorted with network_sort.
+ *
+ * @param a The array to sort
+ * @param i The index of the first element
+ * @param j The index of the last element (exclusive)
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @param partition_fn The partition used to split the subarrays
+ * @param pivot_fn The pivot policy, shared by all the calls of the sort
+ */
+template <class T, class Compare, class Partition, class Pivot>
+void quick_sort_loop(T *a, int i, int j, Compare comp, Partition partition_fn, Pivot *pivot_fn) {
+    // Loop until the subarray is small
+    while (j - i > SMALL_SORT_THRESHOLD) {
+        // Partition the array, sort the smaller partition and keep looping on the larger one
+        move_pivot_to_end(a, i, j, comp, pivot_fn);
+        const int k = partition_fn(a, i, j, comp);
+        if (k - i < j - k - 1) {
+            quick_sort_loop(a, i, k, comp, partition_fn, pivot_fn); // Sort elements less than or equal to the pivot
+            i = k + 1;
+        } else {
+            quick_sort_loop(a, k + 1, j, comp, partition_fn, pivot_fn); // Sort elements greater than the pivot
+            j = k;
+        }
+    }
+
+    // Base case: small subarray
+    network_sort(a, i, j, comp);
+}
+
+/**
+ * QuickSort function to sort the subarray a[i:j] (j exclusive)
+ * @param a The array to sort
+ * @param i The index of the first element
+ * @param j The index of the last element (exclusive)
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @param partition_fn The partition used to split the subarrays
+ * @param pivot_fn The pivot policy, the last element by default (see pivot.h)
+ */
+template <class T, class Compare = std::less<>, class Partition = LomutoPartition, class Pivot = LastPivot>
+void quick_sort(T *a, const int i, const int j, Compare comp = Compare(), Partition partition_fn = Partition(),
+                Pivot pivot_fn = Pivot()) {
+    quick_sort_loop(a, i, j, comp, partition_fn, &pivot_fn);
+}
+
+/**
+ * @brief Main loop of the introsort
+ *
+ * Partitions the subarray like quick_sort, recursing into the smaller partition and looping on the larger one,
+ * so at most O(log n) frames are on the stack. When depth_limit partitions have been performed on the way to a
+ * subarray, it is sorted with heap_sort instead. Subarrays up to INTRO_THRESHOLD elements are sorted with
+ * network_sort if they are not longer than SMALL_SORT_THRESHOLD, with insertion sort otherwise.
+ *
+ * @param a The array to sort
+ * @param i The index of the first element
+ * @param j The index of the last element (exclusive)
+ * @param depth_limit The number of partitions left before switching to heap sort
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @param partition_fn The partition used to split the subarrays
+ * @param pivot_fn The pivot policy, shared by all the calls of the sort
+ */
+template <class T, class Compare, class Partition, class Pivot>
+void intro_sort_loop(T *a, int i, int j, int depth_limit, Compare comp, Partition partition_fn, Pivot *pivot_fn) {
+    while (j - i > INTRO_THRESHOLD) {
+        // Too many unbalanced partitions: fall back to heap sort
+        if (depth_limit == 0) {
+            heap_sort(a, i, j, comp);
+            return;
+        }
+        depth_limit--;
+
+        // Recurse into the smaller partition and keep looping on the larger one
+        move_pivot_to_end(a, i, j, comp, pivot_fn);
+        const int k = partition_fn(a, i, j, comp);
+        if (k - i < j - k - 1) {
+            intro_sort_loop(a, i, k, depth_limit, comp, partition_fn, pivot_fn);
+            i = k + 1;
+        } else {
+            intro_sort_loop(a, k + 1, j, depth_limit, comp, partition_fn, pivot_fn);
+            j = k;
+        }
+    }
+
+    // Base case: small subarray
+    if (j - i <= SMALL_SORT_THRESHOLD) {
+        network_sort(a, i, j, comp);
+    } else {
+        insertion_sort(a, i, j - 1, comp);
+    }
+}
+
+/**
+ * IntroSort function to sort the subarray a[i:j] (j exclusive) in O(n log n) time in the worst case
+ * @param a The array to sort
+ * @param i The index of the first element
+ * @param j The index of the last element (exclusive)
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @param partition_fn The partition used to split the subarrays
+ * @param pivot_fn The pivot policy, the last element by default (see pivot.h)
+ */
+template <class T, class Compare = std::less<>, class Partition = LomutoPartition, class Pivot = LastPivot>
+void intro_sort(T *a, const int i, const int j, Compare comp = Compare(), Partition partition_fn = Partition(),
+                Pivot pivot_fn = Pivot()) {
+    // Allow 2 * floor(log2(n)) partitions before switching to heap sort
+    int depth_limit = 0;
+    for (int n = j - i; n > 1; n >>= 1) {
+        depth_limit += 2;
+    }
+
+    intro_sort_loop(a, i, j, depth_limit, comp, partition_fn, &pivot_fn);
+}
+
+} // namespace sort_lib
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef SORT_LIB_RANDOM_H
+#define SORT_LIB_RANDOM_H
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace sort_lib {
+
+// Seed of the random generators of the sorts when none is given, so that two runs pick the same pivots.
+constexpr uint64_t DEFAULT_RANDOM_SEED = 0x9E3779B97F4A7C15ULL;
+
+// The random generators are small values owned by one sort: every call of a randomized sort creates its own
+// generator from a seed, so concurrent sorts share no state and a sort is reproducible from its seed.
+// A generator is constructed from a 64-bit seed and returns 64 random bits from operator().
+
+/**
+ * @brief Next value of the SplitMix64 sequence, used to expand a seed into the state of a generator
+ * @param state The state of the sequence, advanced by the call
+ * @return The next value
+ */
+inline uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief wyrand generator: one addition and one 64x64->128-bit multiplication per number
+ */
+struct WyRand {
+    uint64_t state; // State of the generator
+
+    explicit WyRand(const uint64_t seed = DEFAULT_RANDOM_SEED) : state(seed) {}
+
+    uint64_t operator()() {
+        state += 0xA0761D6478BD642FULL;
+        const __uint128_t t = static_cast<__uint128_t>(state) * (state ^ 0xE7037ED1A0B428DBULL);
+        return static_cast<uint64_t>(t >> 64) ^ static_cast<uint64_t>(t);
+    }
+};
+
+/**
+ * @brief xoshiro256** generator: 256 bits of state updated with shifts, rotations and xors
+ */
+struct Xoshiro256 {
+    uint64_t s[4]; // State of the generator
+
+    explicit Xoshiro256(uint64_t seed = DEFAULT_RANDOM_SEED) {
+        for (uint64_t &x: s) {
+            x = splitmix64(&seed);
+        }
+    }
+
+    static uint64_t rotl(const uint64_t x, const int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t operator()() {
+        const uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+};
+
+/**
+ * @brief Generator that calls the libc rand(), kept to compare the generators
+ *
+ * rand() uses a global state: the seed is applied with srand() and the generator is not thread-safe.
+ */
+struct LibcRandom {
+    explicit LibcRandom(const uint64_t seed = DEFAULT_RANDOM_SEED) {
+        srand(static_cast<unsigned int>(seed));
+    }
+
+    uint64_t operator()() {
+        // rand() returns 31 bits with glibc, move them to the top
+        return static_cast<uint64_t>(rand()) << 33;
+    }
+};
+
+/**
+ * @brief Reduce 32 random bits to [0, range) with a multiplication and a shift (Lemire)
+ *
+ * Unlike x % range it needs no division, and it uses the high bits of x, which are the best bits of every
+ * generator of this file.
+ *
+ * @param x The random bits
+ * @param range The number of values, greater than zero
+ * @return The reduced value, in [0, range)
+ */
+inline uint32_t reduce_range(const uint32_t x, const uint32_t range) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(x) * range) >> 32);
+}
+
+/**
+ * @brief Generates a random number between i and j
+ *
+ * @param i The lower bound of the random number.
+ * @param j The upper bound of the random number.
+ * @param rng The random generator.
+ * @return int The random number generated.
+ */
+template <class Random>
+int random_between(const int i, const int j, Random *rng) {
+    const auto x = static_cast<uint32_t>((*rng)() >> 32); // Take the high bits of the number
+    return i + static_cast<int>(reduce_range(x, static_cast<uint32_t>(j - i + 1)));
+}
+
+} // namespace sort_lib
+
+#endif
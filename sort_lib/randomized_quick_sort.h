@@ -0,0 +1,32 @@
+#ifndef SORT_LIB_RANDOMIZED_QUICK_SORT_H
+#define SORT_LIB_RANDOMIZED_QUICK_SORT_H
+
+#include <cstdint>
+#include <functional>
+
+#include "quick_sort.h"
+#include "random.h"
+
+namespace sort_lib {
+
+/**
+ * @brief Randomized quick sort algorithm
+ * This function sorts the array using quick_sort with a RandomPivot policy.
+ * The pivots are drawn from a generator of type Random (WyRand by default) owned by the call, so concurrent sorts
+ * share no state and the same seed always selects the same pivots.
+ * @param a Pointer to the array.
+ * @param i Starting index of the subarray.
+ * @param j Ending index of the subarray (exclusive).
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ * @param partition_fn The partition used to split the subarrays.
+ * @param seed The seed of the random generator.
+ */
+template <class T, class Compare = std::less<>, class Partition = LomutoPartition, class Random = WyRand>
+void randomized_quick_sort(T *a, const int i, const int j, Compare comp = Compare(),
+                           Partition partition_fn = Partition(), const uint64_t seed = DEFAULT_RANDOM_SEED) {
+    quick_sort(a, i, j, comp, partition_fn, RandomPivot<Random>(seed));
+}
+
+} // namespace sort_lib
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef SORT_LIB_SORT_BASE_H
+#define SORT_LIB_SORT_BASE_H
+
+#include <functional>
+#include <utility>
+
+namespace sort_lib {
+
+/**
+ * @brief Key extractor that returns the element itself
+ */
+struct Identity {
+    template <class T>
+    constexpr const T &operator()(const T &value) const noexcept {
+        return value;
+    }
+};
+
+/**
+ * @brief Comparator that orders the elements by a key extracted from them
+ *
+ * comp(key(x), key(y)) must be a strict weak ordering, like the comparators of the standard library.
+ */
+template <class KeyFn, class Compare = std::less<>>
+struct KeyCompare {
+    KeyFn key; // Extracts the key of an element
+    Compare comp; // Compares two keys
+
+    template <class T>
+    bool operator()(const T &x, const T &y) const {
+        return comp(key(x), key(y));
+    }
+};
+
+/**
+ * @brief Create a comparator that orders the elements by a key extracted from them
+ * @param key The key extractor, called with a const reference to an element
+ * @param comp The comparator of the keys
+ * @return The comparator of the elements
+ */
+template <class KeyFn, class Compare = std::less<>>
+KeyCompare<KeyFn, Compare> by_key(KeyFn key, Compare comp = Compare()) {
+    return {key, comp};
+}
+
+/**
+ * @brief Pool that executes every task on the calling thread
+ *
+ * The parallel algorithms of the library accept any pool with the same size() and parallel_for() members,
+ * such as the TaskPool of the benchmarks. This one is the default of the algorithms that only use a pool for
+ * their large merges, so that they can be called without one.
+ */
+struct SequentialPool {
+    int size() const {
+        return 1;
+    }
+
+    template <class Body>
+    void parallel_for(const int num_tasks, const Body &body) {
+        for (int t = 0; t < num_tasks; t++) {
+            body(t);
+        }
+    }
+};
+
+/**
+ * @brief Sort the array using the insertion sort algorithm.
+ * @param arr The array to sort
+ * @param left The left index of the array
+ * @param right The right index of the array (inclusive)
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <class T, class Compare = std::less<>>
+void insertion_sort(T arr[], const int left, const int right, Compare comp = Compare()) {
+    for (int i = left + 1; i <= right; i++) {
+        T temp = std::move(arr[i]);
+        int j = i - 1;
+        while (j >= left && comp(temp, arr[j])) {
+            arr[j + 1] = std::move(arr[j]);
+            j--;
+        }
+        arr[j + 1] = std::move(temp);
+    }
+}
+
+/**
+ * @brief Move the element at index k of the heap down until both its children go before it
+ * @param a The array containing the heap
+ * @param i The index of the root of the heap
+ * @param k The index of the element to move, relative to i
+ * @param n The number of elements of the heap
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <class T, class Compare = std::less<>>
+void sift_down(T *a, const int i, int k, const int n, Compare comp = Compare()) {
+    T value = std::move(a[i + k]);
+    while (2 * k + 1 < n) {
+        // Select the larger child
+        int child = 2 * k + 1;
+        if (child + 1 < n && comp(a[i + child], a[i + child + 1])) {
+            child++;
+        }
+        if (!comp(value, a[i + child])) {
+            break;
+        }
+        a[i + k] = std::move(a[i + child]); // Move the larger child up
+        k = child;
+    }
+    a[i + k] = std::move(value);
+}
+
+/**
+ * HeapSort function to sort the subarray a[i:j] (j exclusive)
+ * @param a The array to sort
+ * @param i The index of the first element
+ * @param j The index of the last element (exclusive)
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <class T, class Compare = std::less<>>
+void heap_sort(T *a, const int i, const int j, Compare comp = Compare()) {
+    const int n = j - i;
+
+    // Build a max-heap
+    for (int k = n / 2 - 1; k >= 0; k--) {
+        sift_down(a, i, k, n, comp);
+    }
+
+    // Move the maximum to the end and restore the heap on the remaining elements
+    for (int m = n - 1; m > 0; m--) {
+        std::swap(a[i], a[i + m]);
+        sift_down(a, i, 0, m, comp);
+    }
+}
+
+} // namespace sort_lib
+
+#endif
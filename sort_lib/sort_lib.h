@@ -0,0 +1,24 @@
+#ifndef SORT_LIB_H
+#define SORT_LIB_H
+
+// Header-only library of the sort algorithms benchmarked by the executables of this repository.
+//
+// Every algorithm is a function template on the element type, sorting a[i:j] (or arr[0:n]) in place like the
+// executables do. The comparison sorts take a comparator (std::less<> by default, or by_key() to order records
+// by one of their fields) and the counting sorts take an integer key extractor (Identity by default).
+// With the default arguments on int arrays they compile to the same code as the int-only versions.
+
+#include "counting_sort.h"
+#include "key_index.h"
+#include "merge_path.h"
+#include "merge_sort.h"
+#include "pivot.h"
+#include "quick_3way_sort.h"
+#include "quick_sort.h"
+#include "random.h"
+#include "randomized_quick_sort.h"
+#include "sort_base.h"
+#include "sorting_network.h"
+#include "tim_sort.h"
+
+#endif
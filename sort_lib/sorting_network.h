@@ -0,0 +1,233 @@
+#ifndef SORT_LIB_SORTING_NETWORK_H
+#define SORT_LIB_SORTING_NETWORK_H
+
+#include <climits>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// The vector networks are compiled only for x86-64 with GCC or Clang, which can enable the
+// instruction sets per function, so the users of the library do not depend on -mavx2/-mavx512f.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SORT_LIB_NETWORK_X86
+#include <immintrin.h>
+#endif
+
+// Subarrays up to this length are the base case of the quick sorts, sorted with network_sort.
+// Define SORT_LIB_SMALL_SORT_THRESHOLD (CMake option SMALL_SORT_THRESHOLD) to change it; 1 disables the networks.
+#ifndef SORT_LIB_SMALL_SORT_THRESHOLD
+#define SORT_LIB_SMALL_SORT_THRESHOLD 16
+#endif
+
+namespace sort_lib {
+
+constexpr int SMALL_SORT_THRESHOLD = SORT_LIB_SMALL_SORT_THRESHOLD > 1 ? SORT_LIB_SMALL_SORT_THRESHOLD : 1;
+
+/**
+ * @brief Order two elements: after the call, y does not go before x
+ *
+ * Numbers are ordered with two conditional moves instead of a branch, so the outcome of the comparison is never
+ * mispredicted. Other types are swapped only when needed, which moves less memory for large records.
+ *
+ * @param x The first element
+ * @param y The second element
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <class T, class Compare>
+void compare_exchange(T &x, T &y, Compare comp) {
+    if constexpr (std::is_arithmetic<T>::value) {
+        const bool swap = comp(y, x);
+        const T low = swap ? y : x;
+        const T high = swap ? x : y;
+        x = low;
+        y = high;
+    } else {
+        if (comp(y, x)) {
+            std::swap(x, y);
+        }
+    }
+}
+
+/**
+ * @brief Sort the subarray with Batcher's merge exchange network (Knuth, Algorithm 5.2.2M)
+ *
+ * The sequence of compare-exchanges depends only on the length of the subarray, not on its elements: the only
+ * branches are the loop conditions, which the CPU predicts after a few calls. It performs O(n log^2 n)
+ * compare-exchanges, so it is meant for subarrays up to a few tens of elements.
+ *
+ * @param a Pointer to the array.
+ * @param i Starting index of the subarray.
+ * @param j Ending index of the subarray (exclusive).
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ */
+template <class T, class Compare = std::less<>>
+void merge_exchange_sort(T *a, const int i, const int j, Compare comp = Compare()) {
+    const int n = j - i;
+    if (n <= 1) {
+        return;
+    }
+
+    // t = ceil(log2(n))
+    int t = 0;
+    while ((1 << t) < n) {
+        t++;
+    }
+
+    T *b = a + i;
+    for (int p = 1 << (t - 1); p > 0; p >>= 1) {
+        int q = 1 << (t - 1), r = 0, d = p;
+        while (true) {
+            for (int k = 0; k < n - d; k++) {
+                if ((k & p) == r) {
+                    compare_exchange(b[k], b[k + d], comp);
+                }
+            }
+            if (q == p) {
+                break;
+            }
+            d = q - p;
+            q >>= 1;
+            r = p;
+        }
+    }
+}
+
+#ifdef SORT_LIB_NETWORK_X86
+
+// Subarrays of ints up to this length are sorted with merge_exchange_sort even when a vector network is available.
+constexpr int VECTOR_NETWORK_MIN_LENGTH = 4;
+
+/**
+ * @brief Sort up to 8 ints with a bitonic network on an AVX2 register
+ *
+ * The missing elements are filled with INT_MAX, which ends at the back of the register and is not stored.
+ * Each of the 6 steps exchanges every lane with the lane at distance j with a permutation, a min and a max.
+ *
+ * @param a Pointer to the elements.
+ * @param n Number of elements, at most 8.
+ */
+__attribute__((target("avx2"))) inline void bitonic_sort_8_avx2(int *a, const int n) {
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i load_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(n), lanes);
+    __m256i v = _mm256_blendv_epi8(_mm256_set1_epi32(INT_MAX), _mm256_maskload_epi32(a, load_mask), load_mask);
+
+    for (int k = 2; k <= 8; k <<= 1) {
+        const __m256i k_zero = _mm256_cmpeq_epi32(_mm256_and_si256(lanes, _mm256_set1_epi32(k)), zero);
+        for (int j = k >> 1; j > 0; j >>= 1) {
+            const __m256i j_vector = _mm256_set1_epi32(j);
+            const __m256i partner = _mm256_permutevar8x32_epi32(v, _mm256_xor_si256(lanes, j_vector));
+            // A lane keeps the maximum when it is the upper lane of an ascending pair or the lower lane of a
+            // descending one
+            const __m256i j_zero = _mm256_cmpeq_epi32(_mm256_and_si256(lanes, j_vector), zero);
+            const __m256i take_max = _mm256_xor_si256(j_zero, k_zero);
+            v = _mm256_blendv_epi8(_mm256_min_epi32(v, partner), _mm256_max_epi32(v, partner), take_max);
+        }
+    }
+
+    _mm256_maskstore_epi32(a, load_mask, v);
+}
+
+/**
+ * @brief Sort up to 16 ints with a bitonic network on an AVX-512 register
+ *
+ * Same network as bitonic_sort_8_avx2 on 16 lanes (10 steps), with masked loads and stores.
+ *
+ * @param a Pointer to the elements.
+ * @param n Number of elements, at most 16.
+ */
+__attribute__((target("avx512f"))) inline void bitonic_sort_16_avx512(int *a, const int n) {
+    const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const auto load_mask = static_cast<__mmask16>((1u << n) - 1);
+    const __m512i padding = _mm512_set1_epi32(INT_MAX);
+    __m512i v = _mm512_mask_loadu_epi32(padding, load_mask, a);
+
+    // The masked forms of the permutation, min and max take an explicit source for the lanes they do not write,
+    // GCC implements the unmasked ones with an undefined source that -Wuninitialized reports
+    for (int k = 2; k <= 16; k <<= 1) {
+        const __mmask16 k_set = _mm512_test_epi32_mask(lanes, _mm512_set1_epi32(k));
+        for (int j = k >> 1; j > 0; j >>= 1) {
+            const __m512i j_vector = _mm512_set1_epi32(j);
+            const __m512i partner =
+                _mm512_mask_permutexvar_epi32(padding, 0xFFFF, _mm512_xor_si512(lanes, j_vector), v);
+            const __mmask16 take_max = _mm512_test_epi32_mask(lanes, j_vector) ^ k_set;
+            const __m512i low = _mm512_mask_min_epi32(v, static_cast<__mmask16>(~take_max), v, partner);
+            v = _mm512_mask_max_epi32(low, take_max, v, partner);
+        }
+    }
+
+    _mm512_mask_storeu_epi32(a, load_mask, v);
+}
+
+/**
+ * @brief Vector networks of network_sort
+ */
+enum NetworkKernel_t {
+    SCALAR_NETWORK, // merge_exchange_sort only
+    AVX2_NETWORK, // bitonic_sort_8_avx2 up to 8 elements
+    AVX512_NETWORK, // bitonic_sort_16_avx512 up to 16 elements
+} typedef NetworkKernel;
+
+/**
+ * @brief Get the widest vector network supported by the CPU, detected on the first call
+ * @return The network kernel
+ */
+inline NetworkKernel network_kernel() {
+    static const NetworkKernel kernel = __builtin_cpu_supports("avx512f") ? AVX512_NETWORK
+                                        : __builtin_cpu_supports("avx2")  ? AVX2_NETWORK
+                                                                          : SCALAR_NETWORK;
+    return kernel;
+}
+
+#endif
+
+/**
+ * @brief Sort a small subarray with a sorting network
+ *
+ * Base case of the quick sorts for subarrays up to SMALL_SORT_THRESHOLD elements.
+ *
+ * @param a Pointer to the array.
+ * @param i Starting index of the subarray.
+ * @param j Ending index of the subarray (exclusive).
+ * @param comp The comparator, comp(x, y) is true if x goes before y.
+ */
+template <class T, class Compare = std::less<>>
+void network_sort(T *a, const int i, const int j, Compare comp = Compare()) {
+    merge_exchange_sort(a, i, j, comp);
+}
+
+/**
+ * @brief Sort a small subarray of ints in ascending order with a sorting network
+ *
+ * From 5 to 8 elements are sorted in a vector register when the CPU supports AVX2, from 9 to 16 when it
+ * supports AVX-512; the other lengths and CPUs use merge_exchange_sort.
+ *
+ * @param a Pointer to the array.
+ * @param i Starting index of the subarray.
+ * @param j Ending index of the subarray (exclusive).
+ */
+inline void network_sort(int *a, const int i, const int j, std::less<>) {
+    const int n = j - i;
+#ifdef SORT_LIB_NETWORK_X86
+    // Up to VECTOR_NETWORK_MIN_LENGTH elements, the few compare-exchanges of the scalar network are faster than
+    // the fixed number of steps of the vector networks. The narrowest vector network that fits is the fastest.
+    if (n > VECTOR_NETWORK_MIN_LENGTH) {
+        const NetworkKernel kernel = network_kernel();
+        if (kernel != SCALAR_NETWORK && n <= 8) {
+            bitonic_sort_8_avx2(a + i, n);
+            return;
+        }
+        if (kernel == AVX512_NETWORK && n <= 16) {
+            bitonic_sort_16_avx512(a + i, n);
+            return;
+        }
+    }
+#endif
+    if (n > 1) {
+        merge_exchange_sort(a, i, j, std::less<>());
+    }
+}
+
+} // namespace sort_lib
+
+#endif
@@ -0,0 +1,906 @@
+#ifndef SORT_LIB_TIM_SORT_H
+#define SORT_LIB_TIM_SORT_H
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "merge_path.h"
+#include "sort_base.h"
+
+namespace sort_lib {
+
+// Threshold for switching to insertion sort.
+constexpr int THRESHOLD = 64;
+// The minimum size to enable the tim sort algorithm.
+constexpr int MIN_MERGE = 32;
+// Initial number of consecutive wins of the same run needed to enter galloping mode.
+constexpr int MIN_GALLOP = 7;
+
+// The maximum number of pending runs on the stack.
+// This needs to be large enough to handle worst-case scenarios but small enough
+// to fit in cache. The Powersort policy never needs more than log2(n) + 2 of them.
+constexpr int MAX_PENDING_RUNS = 85;
+
+// Chunks shorter than this are not sorted by a separate task of the parallel tim sort,
+// so that the cost of a task stays small compared to the work it performs.
+constexpr int PARALLEL_MIN_CHUNK = 1 << 14;
+// The parallel tim sort cuts the array into this many chunks per thread, so that the first levels of its merge tree
+// have at least as many pairs as threads and merge each pair on its own task.
+constexpr int PARALLEL_CHUNKS_PER_THREAD = 4;
+// Merges of at least this many elements are split across the pool by merge_runs, when tim_sort is given a pool.
+constexpr int PARALLEL_MERGE_THRESHOLD = 1 << 16;
+
+
+/**
+ * @brief Structure to store a run of elements in the array.
+ */
+struct Run_t {
+    int start; // Start index of the run.
+    int length; // Length of the run.
+    int power; // Power of the boundary with the next run (Powersort policy only).
+} typedef Run;
+
+/**
+ * @brief Structure to store the state shared by the merges of a sort.
+ *
+ * The counters are only updated by the merges instantiated with Count = true, so the timed sorts do not pay for
+ * them.
+ */
+struct MergeState_t {
+    int min_gallop; // Current threshold for entering galloping mode, adapted by the merges.
+    long long comparisons; // Number of comparisons made by the merges.
+    long long moves; // Number of elements written by the merges, including the copies into the temporary array.
+} typedef MergeState;
+
+/**
+ * @brief Structure to store the stack of runs.
+ */
+struct RunStack_t {
+    Run stack[MAX_PENDING_RUNS];
+    int num_runs; // Number of runs currently on the stack.
+    int array_length; // Length of the array being sorted.
+    MergeState state; // State of the merges.
+} typedef RunStack;
+
+/**
+ * @brief Merge policy: decides which runs on the stack are merged after a new run has been pushed.
+ */
+enum MergePolicy_t {
+    TIMSORT_POLICY, // The TimSort invariants, see merge_collapse
+    POWERSORT_POLICY, // The Powersort policy, see power_collapse
+} typedef MergePolicy;
+
+
+/**
+ * @brief Find the position where key should be inserted in a sorted array, before any equivalent element.
+ *
+ * The search starts at hint and doubles the step until it passes the position (exponential search), then
+ * finishes with a binary search, so it takes O(log d) comparisons when the position is d elements from hint.
+ *
+ * @tparam Count Whether the comparisons are counted, only for the operation counts of the benchmark
+ * @param key The value to insert
+ * @param a The sorted array
+ * @param n The length of the array
+ * @param hint The index where the search starts, in [0, n)
+ * @param comparisons The counter of comparisons, incremented by the search if Count is true
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @return k in [0, n] such that a[k - 1] < key <= a[k]
+ */
+template <bool Count = false, class T, class Compare = std::less<>>
+int gallop_left(const T &key, const T a[], const int n, const int hint, long long *comparisons,
+                Compare comp = Compare()) {
+    int count = 1; // Number of comparisons, starting with the one with a[hint]
+    int last_ofs = 0;
+    int ofs = 1;
+
+    if (comp(a[hint], key)) {
+        // Gallop right until a[hint + last_ofs] < key <= a[hint + ofs]
+        const int max_ofs = n - hint;
+        while (ofs < max_ofs && comp(a[hint + ofs], key)) {
+            count++;
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0) { // Integer overflow
+                ofs = max_ofs;
+            }
+        }
+        if (ofs < max_ofs) {
+            count++; // The comparison that stopped the search
+        } else {
+            ofs = max_ofs;
+        }
+        last_ofs += hint;
+        ofs += hint;
+    } else {
+        // Gallop left until a[hint - ofs] < key <= a[hint - last_ofs]
+        const int max_ofs = hint + 1;
+        while (ofs < max_ofs && !comp(a[hint - ofs], key)) {
+            count++;
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0) { // Integer overflow
+                ofs = max_ofs;
+            }
+        }
+        if (ofs < max_ofs) {
+            count++; // The comparison that stopped the search
+        } else {
+            ofs = max_ofs;
+        }
+        const int temp = last_ofs;
+        last_ofs = hint - ofs;
+        ofs = hint - temp;
+    }
+
+    // Binary search in (last_ofs, ofs]: a[last_ofs] < key <= a[ofs]
+    last_ofs++;
+    while (last_ofs < ofs) {
+        const int m = last_ofs + ((ofs - last_ofs) >> 1);
+        count++;
+        if (comp(a[m], key)) {
+            last_ofs = m + 1;
+        } else {
+            ofs = m;
+        }
+    }
+    if constexpr (Count) {
+        *comparisons += count;
+    }
+    return ofs;
+}
+
+/**
+ * @brief Find the position where key should be inserted in a sorted array, after any equivalent element.
+ * @param key The value to insert
+ * @param a The sorted array
+ * @param n The length of the array
+ * @param hint The index where the search starts, in [0, n)
+ * @param comparisons The counter of comparisons, incremented by the search if Count is true
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @return k in [0, n] such that a[k - 1] <= key < a[k]
+ */
+template <bool Count = false, class T, class Compare = std::less<>>
+int gallop_right(const T &key, const T a[], const int n, const int hint, long long *comparisons,
+                 Compare comp = Compare()) {
+    int count = 1; // Number of comparisons, starting with the one with a[hint]
+    int last_ofs = 0;
+    int ofs = 1;
+
+    if (comp(key, a[hint])) {
+        // Gallop left until a[hint - ofs] <= key < a[hint - last_ofs]
+        const int max_ofs = hint + 1;
+        while (ofs < max_ofs && comp(key, a[hint - ofs])) {
+            count++;
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0) { // Integer overflow
+                ofs = max_ofs;
+            }
+        }
+        if (ofs < max_ofs) {
+            count++; // The comparison that stopped the search
+        } else {
+            ofs = max_ofs;
+        }
+        const int temp = last_ofs;
+        last_ofs = hint - ofs;
+        ofs = hint - temp;
+    } else {
+        // Gallop right until a[hint + last_ofs] <= key < a[hint + ofs]
+        const int max_ofs = n - hint;
+        while (ofs < max_ofs && !comp(key, a[hint + ofs])) {
+            count++;
+            last_ofs = ofs;
+            ofs = (ofs << 1) + 1;
+            if (ofs <= 0) { // Integer overflow
+                ofs = max_ofs;
+            }
+        }
+        if (ofs < max_ofs) {
+            count++; // The comparison that stopped the search
+        } else {
+            ofs = max_ofs;
+        }
+        last_ofs += hint;
+        ofs += hint;
+    }
+
+    // Binary search in (last_ofs, ofs]: a[last_ofs] <= key < a[ofs]
+    last_ofs++;
+    while (last_ofs < ofs) {
+        const int m = last_ofs + ((ofs - last_ofs) >> 1);
+        count++;
+        if (comp(key, a[m])) {
+            ofs = m;
+        } else {
+            last_ofs = m + 1;
+        }
+    }
+    if constexpr (Count) {
+        *comparisons += count;
+    }
+    return ofs;
+}
+
+/**
+ * @brief Merge two adjacent runs, copying the first (shorter) one into the temporary array.
+ *
+ * Requires arr[start2] < arr[start1] and arr[start1 + len1 - 1] > arr[start2 + len2 - 1], which merge()
+ * guarantees by trimming the runs. The merge alternates between a one-element-at-a-time mode and a galloping
+ * mode, entered when one run wins min_gallop times in a row, that copies whole blocks found with gallop_left
+ * and gallop_right.
+ *
+ * @tparam Count Whether the comparisons and moves are added to state, only for the operation counts of the benchmark
+ * @param arr The array to merge
+ * @param start1 The index of the first run
+ * @param len1 The length of the first run
+ * @param start2 The index of the second run, equal to start1 + len1
+ * @param len2 The length of the second run
+ * @param temp_arr The temporary array, with room for len1 elements
+ * @param state The galloping threshold, and the operation counters if Count is true, updated by the merge
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <bool Count = false, class T, class Compare = std::less<>>
+void merge_lo(T arr[], const int start1, int len1, const int start2, int len2, T *temp_arr, MergeState *state,
+              Compare comp = Compare()) {
+    // Only the first run is copied: the merged elements never overwrite the unmerged part of the second run
+    std::move(&arr[start1], &arr[start1 + len1], temp_arr);
+    // Every element of both runs is written back exactly once
+    if constexpr (Count) {
+        state->moves += 2 * len1 + len2;
+    }
+
+    int cursor1 = 0; // Next element of the first run, in temp_arr
+    int cursor2 = start2; // Next element of the second run, in arr
+    int dest = start1; // Next position to write in arr
+
+    // The first element of the second run is the smallest of both runs
+    arr[dest++] = std::move(arr[cursor2++]);
+    if (--len2 == 0) {
+        std::move(&temp_arr[cursor1], &temp_arr[cursor1 + len1], &arr[dest]);
+        return;
+    }
+    if (len1 == 1) {
+        std::move(&arr[cursor2], &arr[cursor2 + len2], &arr[dest]);
+        arr[dest + len2] = std::move(temp_arr[cursor1]); // The last element of the first run is the largest
+        return;
+    }
+
+    int gallop = state->min_gallop;
+    long long comparisons = 0;
+    while (true) {
+        int count1 = 0; // Number of consecutive elements taken from the first run
+        int count2 = 0; // Number of consecutive elements taken from the second run
+
+        // Merge one element at a time until a run starts winning consistently
+        do {
+            if constexpr (Count) {
+                comparisons++;
+            }
+            if (comp(arr[cursor2], temp_arr[cursor1])) {
+                arr[dest++] = std::move(arr[cursor2++]);
+                count2++;
+                count1 = 0;
+                if (--len2 == 0) {
+                    goto done;
+                }
+            } else {
+                arr[dest++] = std::move(temp_arr[cursor1++]);
+                count1++;
+                count2 = 0;
+                if (--len1 == 1) {
+                    goto done;
+                }
+            }
+        } while ((count1 | count2) < gallop);
+
+        // Gallop: copy whole blocks until both runs win less than MIN_GALLOP elements in a row
+        do {
+            count1 = gallop_right<Count>(arr[cursor2], &temp_arr[cursor1], len1, 0, &comparisons, comp);
+            if (count1 != 0) {
+                std::move(&temp_arr[cursor1], &temp_arr[cursor1 + count1], &arr[dest]);
+                dest += count1;
+                cursor1 += count1;
+                len1 -= count1;
+                if (len1 <= 1) {
+                    goto done;
+                }
+            }
+            arr[dest++] = std::move(arr[cursor2++]);
+            if (--len2 == 0) {
+                goto done;
+            }
+
+            count2 = gallop_left<Count>(temp_arr[cursor1], &arr[cursor2], len2, 0, &comparisons, comp);
+            if (count2 != 0) {
+                std::move(&arr[cursor2], &arr[cursor2 + count2], &arr[dest]);
+                dest += count2;
+                cursor2 += count2;
+                len2 -= count2;
+                if (len2 == 0) {
+                    goto done;
+                }
+            }
+            arr[dest++] = std::move(temp_arr[cursor1++]);
+            if (--len1 == 1) {
+                goto done;
+            }
+
+            // Galloping pays off: make it easier to enter it again
+            gallop--;
+        } while (count1 >= MIN_GALLOP || count2 >= MIN_GALLOP);
+
+        // Galloping did not pay off: make it harder to enter it again
+        if (gallop < 0) {
+            gallop = 0;
+        }
+        gallop += 2;
+    }
+
+done:
+    state->min_gallop = gallop < 1 ? 1 : gallop;
+    if constexpr (Count) {
+        state->comparisons += comparisons;
+    }
+
+    if (len1 == 1) {
+        // The last element of the first run goes after the rest of the second run
+        std::move(&arr[cursor2], &arr[cursor2 + len2], &arr[dest]);
+        arr[dest + len2] = std::move(temp_arr[cursor1]);
+    } else {
+        // The second run is exhausted: copy the rest of the first one
+        std::move(&temp_arr[cursor1], &temp_arr[cursor1 + len1], &arr[dest]);
+    }
+}
+
+/**
+ * @brief Merge two adjacent runs from the end, copying the second (shorter) one into the temporary array.
+ * @param arr The array to merge
+ * @param start1 The index of the first run
+ * @param len1 The length of the first run
+ * @param start2 The index of the second run, equal to start1 + len1
+ * @param len2 The length of the second run
+ * @param temp_arr The temporary array, with room for len2 elements
+ * @param state The galloping threshold, and the operation counters if Count is true, updated by the merge
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <bool Count = false, class T, class Compare = std::less<>>
+void merge_hi(T arr[], const int start1, int len1, const int start2, int len2, T *temp_arr, MergeState *state,
+              Compare comp = Compare()) {
+    // Only the second run is copied: the merged elements never overwrite the unmerged part of the first run
+    std::move(&arr[start2], &arr[start2 + len2], temp_arr);
+    // Every element of both runs is written back exactly once
+    if constexpr (Count) {
+        state->moves += len1 + 2 * len2;
+    }
+
+    int cursor1 = start1 + len1 - 1; // Next element of the first run, in arr
+    int cursor2 = len2 - 1; // Next element of the second run, in temp_arr
+    int dest = start2 + len2 - 1; // Next position to write in arr
+
+    // The last element of the first run is the largest of both runs
+    arr[dest--] = std::move(arr[cursor1--]);
+    if (--len1 == 0) {
+        std::move(temp_arr, &temp_arr[len2], &arr[dest - (len2 - 1)]);
+        return;
+    }
+    if (len2 == 1) {
+        dest -= len1;
+        cursor1 -= len1;
+        std::move_backward(&arr[cursor1 + 1], &arr[cursor1 + 1 + len1], &arr[dest + 1 + len1]);
+        arr[dest] = std::move(temp_arr[cursor2]); // The first element of the second run is the smallest
+        return;
+    }
+
+    int gallop = state->min_gallop;
+    long long comparisons = 0;
+    while (true) {
+        int count1 = 0; // Number of consecutive elements taken from the first run
+        int count2 = 0; // Number of consecutive elements taken from the second run
+
+        // Merge one element at a time until a run starts winning consistently
+        do {
+            if constexpr (Count) {
+                comparisons++;
+            }
+            if (comp(temp_arr[cursor2], arr[cursor1])) {
+                arr[dest--] = std::move(arr[cursor1--]);
+                count1++;
+                count2 = 0;
+                if (--len1 == 0) {
+                    goto done;
+                }
+            } else {
+                arr[dest--] = std::move(temp_arr[cursor2--]);
+                count2++;
+                count1 = 0;
+                if (--len2 == 1) {
+                    goto done;
+                }
+            }
+        } while ((count1 | count2) < gallop);
+
+        // Gallop: copy whole blocks until both runs win less than MIN_GALLOP elements in a row
+        do {
+            count1 = len1 - gallop_right<Count>(temp_arr[cursor2], &arr[start1], len1, len1 - 1, &comparisons, comp);
+            if (count1 != 0) {
+                dest -= count1;
+                cursor1 -= count1;
+                len1 -= count1;
+                std::move_backward(&arr[cursor1 + 1], &arr[cursor1 + 1 + count1], &arr[dest + 1 + count1]);
+                if (len1 == 0) {
+                    goto done;
+                }
+            }
+            arr[dest--] = std::move(temp_arr[cursor2--]);
+            if (--len2 == 1) {
+                goto done;
+            }
+
+            count2 = len2 - gallop_left<Count>(arr[cursor1], temp_arr, len2, len2 - 1, &comparisons, comp);
+            if (count2 != 0) {
+                dest -= count2;
+                cursor2 -= count2;
+                len2 -= count2;
+                std::move(&temp_arr[cursor2 + 1], &temp_arr[cursor2 + 1 + count2], &arr[dest + 1]);
+                if (len2 <= 1) {
+                    goto done;
+                }
+            }
+            arr[dest--] = std::move(arr[cursor1--]);
+            if (--len1 == 0) {
+                goto done;
+            }
+
+            // Galloping pays off: make it easier to enter it again
+            gallop--;
+        } while (count1 >= MIN_GALLOP || count2 >= MIN_GALLOP);
+
+        // Galloping did not pay off: make it harder to enter it again
+        if (gallop < 0) {
+            gallop = 0;
+        }
+        gallop += 2;
+    }
+
+done:
+    state->min_gallop = gallop < 1 ? 1 : gallop;
+    if constexpr (Count) {
+        state->comparisons += comparisons;
+    }
+
+    if (len2 == 1) {
+        // The first element of the second run goes before the rest of the first run
+        dest -= len1;
+        cursor1 -= len1;
+        std::move_backward(&arr[cursor1 + 1], &arr[cursor1 + 1 + len1], &arr[dest + 1 + len1]);
+        arr[dest] = std::move(temp_arr[cursor2]);
+    } else {
+        // The first run is exhausted: copy the rest of the second one
+        std::move(temp_arr, &temp_arr[len2], &arr[dest - (len2 - 1)]);
+    }
+}
+
+/**
+ * @brief Merge two sorted subarrays into a single sorted array.
+ *
+ * The elements of the first subarray that do not go after the first element of the second one, and the
+ * elements of the second subarray that do not go before the last element of the first one, are already in
+ * place and are skipped with gallop_right and gallop_left. The rest is merged with merge_lo or merge_hi,
+ * depending on which subarray is shorter.
+ *
+ * @tparam Count Whether the comparisons and moves are added to state, see merge_lo
+ * @param arr The array to merge
+ * @param left The left index of the first subarray
+ * @param mid The right index of the first subarray (inclusive)
+ * @param right The right index of the second subarray (inclusive)
+ * @param temp_arr The temporary array, with room for the shorter subarray
+ * @param state The galloping threshold, and the operation counters if Count is true, updated by the merge
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <bool Count = false, class T, class Compare = std::less<>>
+void merge(T arr[], int left, const int mid, int right, T *temp_arr, MergeState *state, Compare comp = Compare()) {
+    // Elements of the first run not greater than the first element of the second run are already in place
+    const int skip = gallop_right<Count>(arr[mid + 1], &arr[left], mid - left + 1, 0, &state->comparisons, comp);
+    left += skip;
+    if (left > mid) {
+        return; // The runs are already in order
+    }
+
+    // Elements of the second run not less than the last element of the first run are already in place
+    right = mid + gallop_left<Count>(arr[mid], &arr[mid + 1], right - mid, right - mid - 1, &state->comparisons, comp);
+    if (right == mid) {
+        return;
+    }
+
+    const int len1 = mid - left + 1;
+    const int len2 = right - mid;
+    if (len1 <= len2) {
+        merge_lo<Count>(arr, left, len1, mid + 1, len2, temp_arr, state, comp);
+    } else {
+        merge_hi<Count>(arr, left, len1, mid + 1, len2, temp_arr, state, comp);
+    }
+}
+
+/**
+ * @brief Calculate the minimum run length for the array.
+ * @param n The length of the array
+ * @return The minimum run length
+ */
+inline int calculate_minrun(int n) {
+    int r = 0;
+    // Compute the minimum run length
+    while (n >= THRESHOLD) {
+        r |= (n & 1);
+        n >>= 1;
+    }
+    return n + r;
+}
+
+/**
+ * @brief Count the length of a naturally occurring run in the array starting at 'start'.
+ * A run is a sequence of elements that are either non-decreasing or strictly decreasing.
+ * Decreasing runs are reversed in place.
+ * @param arr The array to count the run
+ * @param start The start index of the run
+ * @param n The length of the array
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @return The length of the run
+ */
+template <class T, class Compare = std::less<>>
+int count_run(T arr[], const int start, const int n, Compare comp = Compare()) {
+    if (start == n - 1) {
+        return 1; // Single element is a run.
+    }
+
+    int curr = start;
+    // Determine if the run is increasing or decreasing based on the first two
+    // elements.
+    if (!comp(arr[curr + 1], arr[curr])) {
+        // Increasing run.
+        while (curr < n - 1 && !comp(arr[curr + 1], arr[curr])) {
+            curr++;
+        }
+    } else {
+        // Decreasing run.
+        while (curr < n - 1 && comp(arr[curr + 1], arr[curr])) {
+            curr++;
+        }
+        // Reverse the decreasing run to make it increasing.
+        std::reverse(&arr[start], &arr[curr + 1]);
+    }
+    // Return the length of the run.
+    return curr - start + 1;
+}
+
+/**
+ * @brief Extend the run to the maximum possible length and sort it using the insertion sort algorithm.
+ * @param arr The array to sort
+ * @param start The start index of the run
+ * @param end The end index of the run
+ * @param n The length of the array
+ * @param min_run The minimum run length
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <class T, class Compare = std::less<>>
+void extend_run_and_sort(T arr[], const int start, int *end, const int n, const int min_run,
+                         Compare comp = Compare()) {
+    const int run_length = count_run(arr, start, n, comp);
+    *end = start + run_length - 1;
+
+    // If the run is shorter than minrun, extend it to minrun.
+    if (run_length < min_run) {
+        const int new_end = (start + min_run - 1 < n - 1) ? start + min_run - 1 : n - 1;
+        insertion_sort(arr, start, new_end, comp);
+        *end = new_end;
+    }
+}
+
+/**
+ * @brief Push a run onto the stack of runs.
+ * @param stack The stack of runs
+ * @param start The start index of the run
+ * @param length The length of the run
+ */
+inline void push_run(RunStack *stack, const int start, const int length) {
+    // Add the run to the array while the invariants are maintained.
+    stack->stack[stack->num_runs].start = start;
+    stack->stack[stack->num_runs].length = length;
+    stack->num_runs++;
+}
+
+/**
+ * @brief Compute the power of the boundary between two adjacent runs.
+ *
+ * The power is the depth of the boundary in the perfectly balanced binary tree over the array: the index of the
+ * first bit where the binary expansions of the midpoints of the two runs, divided by n, differ.
+ *
+ * @param start1 The start index of the first run
+ * @param length1 The length of the first run
+ * @param length2 The length of the second run
+ * @param n The length of the array
+ * @return The power of the boundary, at least 1
+ */
+inline int node_power(const int start1, const int length1, const int length2, const int n) {
+    long long a = 2LL * start1 + length1; // Twice the midpoint of the first run
+    long long b = a + length1 + length2; // Twice the midpoint of the second run
+    int power = 0;
+
+    // Compare the bits of a / 2n and b / 2n, starting from the most significant one
+    while (true) {
+        power++;
+        if (a >= n) { // Both bits are 1
+            a -= n;
+            b -= n;
+        } else if (b >= n) { // The bit of a is 0, the bit of b is 1
+            break;
+        }
+        a <<= 1;
+        b <<= 1;
+    }
+    return power;
+}
+
+/**
+ * @brief Merge two sorted subarrays on the pool, splitting the merge into independent segments.
+ *
+ * The subarrays are merged into temp_arr by merge_path_merge, then the result is copied back in parallel.
+ * The merge is stable.
+ *
+ * @param arr The array to merge
+ * @param left The left index of the first subarray
+ * @param mid The right index of the first subarray (inclusive)
+ * @param right The right index of the second subarray (inclusive)
+ * @param temp_arr The temporary array, with room for right + 1 elements
+ * @param pool The pool that executes the segments
+ * @param segments The number of segments
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ */
+template <class T, class Pool, class Compare = std::less<>>
+void parallel_merge(T arr[], const int left, const int mid, const int right, T *temp_arr, Pool *pool,
+                    const int segments, Compare comp = Compare()) {
+    // The runs are already in order
+    if (!comp(arr[mid + 1], arr[mid])) {
+        return;
+    }
+
+    const int n1 = mid - left + 1;
+    const int n2 = right - mid;
+    const int total = n1 + n2;
+
+    // Merge the segments into the temporary array
+    merge_path_merge(&arr[left], n1, &arr[mid + 1], n2, &temp_arr[left], pool, segments, comp);
+
+    // Copy the merged segments back
+    pool->parallel_for(segments, [=](const int s) {
+        const int k_begin = static_cast<int>(static_cast<long long>(total) * s / segments);
+        const int k_end = static_cast<int>(static_cast<long long>(total) * (s + 1) / segments);
+        std::move(&temp_arr[left + k_begin], &temp_arr[left + k_end], &arr[left + k_begin]);
+    });
+}
+
+/**
+ * @brief Merge two runs on the stack at indices a and b.
+ * Used by the merge policies. This should not be called directly or the stack invariants may be violated.
+ * Merges of at least PARALLEL_MERGE_THRESHOLD elements run on the pool, if any, with parallel_merge.
+ * @param arr The array to sort
+ * @param stack The stack of runs
+ * @param left The index of the first run
+ * @param right The index of the second run
+ * @param temp_arr The temporary array to store the merged array
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @param pool The pool that executes the large merges, or nullptr to merge on the calling thread
+ */
+template <bool Count, class T, class Compare, class Pool>
+void merge_runs(T arr[], RunStack *stack, const int left, const int right, T *temp_arr, Compare comp, Pool *pool) {
+    const int start_left = stack->stack[left].start;
+    const int length_left = stack->stack[left].length;
+    const int start_right = stack->stack[right].start;
+    const int length_right = stack->stack[right].length;
+
+    const int mid = start_left + length_left - 1;
+    const int end = start_right + length_right - 1;
+    if (pool != nullptr && length_left + length_right >= PARALLEL_MERGE_THRESHOLD) {
+        // Large merges run on all the threads of the pool
+        parallel_merge(arr, start_left, mid, end, temp_arr, pool, pool->size(), comp);
+    } else {
+        merge<Count>(arr, start_left, mid, end, temp_arr, &stack->state, comp);
+    }
+
+    stack->stack[left].length += length_right;
+    for (int i = right; i < stack->num_runs - 1; i++) {
+        stack->stack[i] = stack->stack[i + 1];
+    }
+    stack->num_runs--;
+}
+
+/**
+ * @brief Merge runs on the stack following the TimSort invariants
+ * @param arr The array to sort
+ * @param stack The stack of runs
+ * @param temp_arr The temporary array to store the merged array
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @param pool The pool that executes the large merges, or nullptr
+ */
+template <bool Count, class T, class Compare, class Pool>
+void merge_collapse(T arr[], RunStack *stack, T *temp_arr, Compare comp, Pool *pool) {
+    while (stack->num_runs > 1) {
+        int n = stack->num_runs - 2;
+        if (n > 0 && stack->stack[n - 1].length <= stack->stack[n].length + stack->stack[n + 1].length) {
+            if (stack->stack[n - 1].length < stack->stack[n + 1].length) {
+                n--;
+            }
+            merge_runs<Count>(arr, stack, n, n + 1, temp_arr, comp, pool);
+        } else if (stack->stack[n].length <= stack->stack[n + 1].length) {
+            merge_runs<Count>(arr, stack, n, n + 1, temp_arr, comp, pool);
+        } else {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Merge runs on the stack following the Powersort policy
+ *
+ * The power of the boundary between the previous run and the run just pushed is computed with node_power, then
+ * the runs below are merged while their boundary has a greater power. The powers on the stack are strictly
+ * increasing, and the total merge cost is within O(n) of the optimal merge tree of the runs.
+ *
+ * @param arr The array to sort
+ * @param stack The stack of runs
+ * @param temp_arr The temporary array to store the merged array
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @param pool The pool that executes the large merges, or nullptr
+ */
+template <bool Count, class T, class Compare, class Pool>
+void power_collapse(T arr[], RunStack *stack, T *temp_arr, Compare comp, Pool *pool) {
+    if (stack->num_runs < 2) {
+        return;
+    }
+
+    const Run previous = stack->stack[stack->num_runs - 2];
+    const Run last = stack->stack[stack->num_runs - 1];
+    const int power = node_power(previous.start, previous.length, last.length, stack->array_length);
+
+    // Merge the runs below the new one while their boundary is deeper in the tree than the new boundary
+    while (stack->num_runs > 2 && stack->stack[stack->num_runs - 3].power > power) {
+        merge_runs<Count>(arr, stack, stack->num_runs - 3, stack->num_runs - 2, temp_arr, comp, pool);
+    }
+    stack->stack[stack->num_runs - 2].power = power;
+}
+
+/**
+ * @brief Sort the array using the TimSort algorithm.
+ *
+ * The sort is stable.
+ *
+ * @tparam Count Whether the merges count their comparisons and moves in run_stack->state, only for the operation
+ * counts of the benchmark
+ * @param arr The array to sort
+ * @param n The length of the array
+ * @param temp_arr The temporary array to store the merged array
+ * @param run_stack The stack of runs
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @param policy The merge policy: TIMSORT_POLICY (merge_collapse) or POWERSORT_POLICY (power_collapse)
+ * @param pool The pool that executes the merges of at least PARALLEL_MERGE_THRESHOLD elements, or nullptr
+ */
+template <bool Count = false, class T, class Compare = std::less<>, class Pool = SequentialPool>
+void tim_sort(T arr[], const int n, T *temp_arr, RunStack *run_stack, Compare comp = Compare(),
+              const MergePolicy policy = TIMSORT_POLICY, Pool *pool = nullptr) {
+    if (n < MIN_MERGE) {
+        // For very small arrays, use insertion sort directly.
+        insertion_sort(arr, 0, n - 1, comp);
+        return;
+    }
+    // Calculate the minimum run length.
+    const int minrun = calculate_minrun(n);
+
+    // A pool of a single thread would only add the overhead of its tasks
+    if (pool != nullptr && pool->size() <= 1) {
+        pool = nullptr;
+    }
+
+    run_stack->num_runs = 0;
+    run_stack->array_length = n;
+    run_stack->state.min_gallop = MIN_GALLOP;
+    run_stack->state.comparisons = 0;
+    run_stack->state.moves = 0;
+    int start = 0;
+    // Divide the array into runs and sort them.
+    while (start < n) {
+        int end;
+        extend_run_and_sort(arr, start, &end, n, minrun, comp);
+        // Push the run onto the stack.
+        push_run(run_stack, start, end - start + 1);
+        // Merge runs following the merge policy.
+        if (policy == POWERSORT_POLICY) {
+            power_collapse<Count>(arr, run_stack, temp_arr, comp, pool);
+        } else {
+            merge_collapse<Count>(arr, run_stack, temp_arr, comp, pool);
+        }
+
+        start = end + 1;
+    }
+
+    // Merge any remaining runs on the stack.
+    while (run_stack->num_runs > 1) {
+        int m = run_stack->num_runs - 2;
+        if (m >= 0) {
+            merge_runs<Count>(arr, run_stack, m, m + 1, temp_arr, comp, pool);
+        }
+    }
+}
+
+/**
+ * @brief Sort the array using a parallel TimSort.
+ *
+ * The array is cut into PARALLEL_CHUNKS_PER_THREAD chunks per thread (fewer if they would be shorter than
+ * PARALLEL_MIN_CHUNK) and every chunk is sorted by tim_sort on its own task, which detects and extends the runs in
+ * parallel. The sorted chunks are merged pairwise, one level of the merge tree at a time: while a level has at
+ * least as many pairs as threads (the first two levels with the full number of chunks), each pair is merged by
+ * merge() on its own task; the following levels merge every pair by parallel_merge, with the threads shared among
+ * the pairs.
+ * The sort is stable.
+ *
+ * @param arr The array to sort
+ * @param n The length of the array
+ * @param temp_arr The temporary array to store the merged array, with room for n elements
+ * @param pool The pool that executes the sort
+ * @param comp The comparator, comp(x, y) is true if x goes before y
+ * @param policy The merge policy used to sort the chunks
+ */
+template <class T, class Pool, class Compare = std::less<>>
+void parallel_tim_sort(T arr[], const int n, T *temp_arr, Pool *pool, Compare comp = Compare(),
+                       const MergePolicy policy = TIMSORT_POLICY) {
+    const int threads = pool->size();
+
+    // Cut the array into several chunks per thread, unless the chunks would be too short
+    const int max_chunks = threads * PARALLEL_CHUNKS_PER_THREAD;
+    const int num_chunks = n / PARALLEL_MIN_CHUNK < max_chunks ? n / PARALLEL_MIN_CHUNK : max_chunks;
+    if (num_chunks <= 1) {
+        RunStack run_stack;
+        tim_sort(arr, n, temp_arr, &run_stack, comp, policy);
+        return;
+    }
+    std::vector<int> bounds(num_chunks + 1);
+    for (int c = 0; c <= num_chunks; c++) {
+        bounds[c] = static_cast<int>(static_cast<long long>(n) * c / num_chunks);
+    }
+
+    // Find, extend and merge the runs of each chunk in parallel
+    pool->parallel_for(num_chunks, [&](const int c) {
+        RunStack run_stack;
+        tim_sort(&arr[bounds[c]], bounds[c + 1] - bounds[c], &temp_arr[bounds[c]], &run_stack, comp, policy);
+    });
+
+    // Merge the sorted blocks pairwise, one level of the merge tree at a time
+    for (int width = 1; width < num_chunks; width *= 2) {
+        const int num_blocks = (num_chunks + width - 1) / width;
+        const int num_pairs = num_blocks / 2; // The last block is left alone if the number is odd
+
+        if (num_pairs >= threads) {
+            // Enough pairs to keep every thread busy: merge each pair sequentially
+            pool->parallel_for(num_pairs, [&](const int p) {
+                const int c = 2 * width * p;
+                const int end = c + 2 * width < num_chunks ? c + 2 * width : num_chunks;
+                MergeState state = {MIN_GALLOP, 0, 0};
+                merge(arr, bounds[c], bounds[c + width] - 1, bounds[end] - 1, &temp_arr[bounds[c]], &state, comp);
+            });
+        } else {
+            // Share the threads among the pairs and split each merge into segments
+            const int segments = (threads + num_pairs - 1) / num_pairs;
+            pool->parallel_for(num_pairs, [&](const int p) {
+                const int c = 2 * width * p;
+                const int end = c + 2 * width < num_chunks ? c + 2 * width : num_chunks;
+                parallel_merge(arr, bounds[c], bounds[c + width] - 1, bounds[end] - 1, temp_arr, pool, segments,
+                               comp);
+            });
+        }
+    }
+}
+
+} // namespace sort_lib
+
+#endif
@@ -1,240 +1,128 @@
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <string>
 #include <vector>
 
 #include "sort.h"
+#include "tim_sort.h"
 #include "utils.h"
 
 // ------------------------ Algorithm Code ------------------------
 
-// Function to perform insertion sort on a subarray.
-void insertion_sort(int arr[], const int left, const int right) {
-    for (int i = left + 1; i <= right; i++) {
-        const int temp = arr[i];
-        int j = i - 1;
-        while (j >= left && arr[j] > temp) {
-            arr[j + 1] = arr[j];
-            j--;
-        }
-        arr[j + 1] = temp;
-    }
-}
-
-// Function to merge two sorted sub arrays.
-// It uses the merge operation from the merge sort algorithm.
-void merge(int arr[], const int left, const int mid, const int right, int *temp_arr) {
-    const int left_len = mid - left + 1;
-    const int right_len = right - mid;
-
-    memcpy(temp_arr, &arr[left], left_len * sizeof(int));
-    memcpy(temp_arr + left_len, &arr[mid + 1], right_len * sizeof(int));
-
-    int i = 0;
-    int j = 0;
-    int k = left;
-
-    while (i < left_len && j < right_len) {
-        if (temp_arr[i] <= temp_arr[left_len + j]) {
-            arr[k] = temp_arr[i];
-            i++;
-        } else {
-            arr[k] = temp_arr[left_len + j];
-            j++;
-        }
-        k++;
-    }
-
-    if (i < left_len) {
-        memcpy(&arr[k], &temp_arr[i], (left_len - i) * sizeof(int));
-    }
+// The tim sorts and the merges are implemented by sort_lib, see tim_sort.h
 
-    if (j < right_len) {
-        memcpy(&arr[k], &temp_arr[left_len + j], (right_len - j) * sizeof(int));
-    }
-}
-
-// Function to calculate the minimum run length.
-int calculate_minrun(int n) {
-    int r = 0;
-    // Compute the minimum run length
-    while (n >= THRESHOLD) {
-        r |= (n & 1);
-        n >>= 1;
-    }
-    return n + r;
-}
-
-// Counts the length of a naturally occurring run in the array starting at
-// 'start'. A run is a sequence of elements that are either non-decreasing or
-// strictly decreasing.
-int count_run(int arr[], const int start, const int n) {
-    if (start == n - 1) {
-        return 1; // Single element is a run.
-    }
-
-    int curr = start;
-    // Determine if the run is increasing or decreasing based on the first two
-    // elements.
-    if (arr[curr] <= arr[curr + 1]) {
-        // Increasing run.
-        while (curr < n - 1 && arr[curr] <= arr[curr + 1]) {
-            curr++;
-        }
-    } else {
-        // Decreasing run.
-        while (curr < n - 1 && arr[curr] > arr[curr + 1]) {
-            curr++;
-        }
-        // Reverse the decreasing run to make it increasing.
-        int left = start;
-        int right = curr;
-        while (left < right) {
-            const int temp = arr[left];
-            arr[left] = arr[right];
-            arr[right] = temp;
-            left++;
-            right--;
-        }
-    }
-    // Return the length of the run.
-    return curr - start + 1;
-}
+// ------------------------ Benchmarking Code ------------------------
 
-// Extends a short run to the minimum length (minrun) using insertion sort if
-// necessary and sorts the extended run.
-void extend_run_and_sort(int arr[], const int start, int *end, const int n, const int min_run) {
-    const int run_length = count_run(arr, start, n);
-    *end = start + run_length - 1;
-
-    // If the run is shorter than minrun, extend it to minrun.
-    if (run_length < min_run) {
-        const int new_end = (start + min_run - 1 < n - 1) ? start + min_run - 1 : n - 1;
-        insertion_sort(arr, start, new_end);
-        *end = new_end;
-    }
+long long benchmark_algorithm(const int n, int data[], BenchmarkArena *arena, const sort_lib::MergePolicy policy,
+                              TaskPool *pool) {
+    // Reuse the buffers of the arena to avoid the overhead of malloc
+    const int ring_size = copy_ring_size(n * sizeof(int));
+    auto *data_copy = arena->get<int>(COPY_BUFFER, static_cast<long long>(ring_size) * n);
+    auto *temp_arr = arena->get<int>(TEMP_BUFFER, n);
+    auto *run_stacks = arena->get<sort_lib::RunStack>(STATE_BUFFER, ring_size);
+
+    return measure_algorithm(
+            ring_size,
+            [&](const int k) {
+                // Duplicate the input data
+                memcpy(data_copy + static_cast<long long>(k) * n, data, n * sizeof(int));
+                // Clear the run stack
+                memset(&run_stacks[k], 0, sizeof(sort_lib::RunStack));
+                // Clear the temporary array
+                memset(temp_arr, 0, n * sizeof(int));
+            },
+            [&](const int k) {
+                // Call the sort function
+                sort_lib::tim_sort(data_copy + static_cast<long long>(k) * n, n, temp_arr, &run_stacks[k],
+                                   std::less<>(), policy, pool);
+            });
 }
 
-// Pushes a run onto the stack.
-void push_run(RunStack *stack, const int start, const int length) {
-    // Add the run to the array while the invariants are maintained.
-    stack->stack[stack->num_runs].start = start;
-    stack->stack[stack->num_runs].length = length;
-    stack->num_runs++;
+long long benchmark_parallel_algorithm(const int n, int data[], BenchmarkArena *arena, TaskPool *pool,
+                                       const sort_lib::MergePolicy policy) {
+    // Reuse the buffers of the arena to avoid the overhead of malloc
+    const int ring_size = copy_ring_size(n * sizeof(int));
+    auto *data_copy = arena->get<int>(COPY_BUFFER, static_cast<long long>(ring_size) * n);
+    auto *temp_arr = arena->get<int>(TEMP_BUFFER, n);
+
+    return measure_algorithm(
+            ring_size,
+            [&](const int k) {
+                // Duplicate the input data
+                memcpy(data_copy + static_cast<long long>(k) * n, data, n * sizeof(int));
+            },
+            [&](const int k) {
+                // Call the sort function
+                sort_lib::parallel_tim_sort(data_copy + static_cast<long long>(k) * n, n, temp_arr, pool,
+                                            std::less<>(), policy);
+            });
 }
 
-// Merges runs on the stack to maintain the stacking invariants.
-void merge_collapse(int arr[], RunStack *stack, int *temp_arr) {
-    while (stack->num_runs > 1) {
-        int n = stack->num_runs - 2;
-        if (n > 0 && stack->stack[n - 1].length <= stack->stack[n].length + stack->stack[n + 1].length) {
-            if (stack->stack[n - 1].length < stack->stack[n + 1].length) {
-                n--;
-            }
-            merge_runs(arr, stack, n, n + 1, temp_arr);
-        } else if (stack->stack[n].length <= stack->stack[n + 1].length) {
-            merge_runs(arr, stack, n, n + 1, temp_arr);
-        } else {
-            break;
-        }
-    }
+long long benchmark_merge(const int n, int data[], BenchmarkArena *arena, TaskPool *pool) {
+    // Reuse the buffers of the arena to avoid the overhead of malloc
+    const int ring_size = copy_ring_size(n * sizeof(int));
+    auto *data_copy = arena->get<int>(COPY_BUFFER, static_cast<long long>(ring_size) * n);
+    auto *temp_arr = arena->get<int>(TEMP_BUFFER, n);
+
+    return measure_algorithm(
+            ring_size,
+            [&](const int k) {
+                // Duplicate the input data
+                memcpy(data_copy + static_cast<long long>(k) * n, data, n * sizeof(int));
+            },
+            [&](const int k) {
+                // Call the merge function
+                int *arr = data_copy + static_cast<long long>(k) * n;
+                if (pool != nullptr) {
+                    sort_lib::parallel_merge(arr, 0, n / 2 - 1, n - 1, temp_arr, pool, pool->size());
+                } else {
+                    sort_lib::MergeState state = {sort_lib::MIN_GALLOP, 0, 0};
+                    sort_lib::merge(arr, 0, n / 2 - 1, n - 1, temp_arr, &state);
+                }
+            });
 }
 
-// Merges two runs on the stack at indices a and b.
-void merge_runs(int arr[], RunStack *stack, const int left, const int right, int *temp_arr) {
-    const int start_left = stack->stack[left].start;
-    const int length_left = stack->stack[left].length;
-    const int start_right = stack->stack[right].start;
-    const int length_right = stack->stack[right].length;
-
-    merge(arr, start_left, start_left + length_left - 1, start_right + length_right - 1, temp_arr);
-
-    stack->stack[left].length += length_right;
-    for (int i = right; i < stack->num_runs - 1; i++) {
-        stack->stack[i] = stack->stack[i + 1];
-    }
-    stack->num_runs--;
+void count_algorithm(const int n, const int data[], BenchmarkArena *arena, const sort_lib::MergePolicy policy,
+                     long long *comparisons, long long *moves) {
+    // Reuse the buffers of the arena
+    auto *data_copy = arena->get<int>(COPY_BUFFER, n);
+    auto *temp_arr = arena->get<int>(TEMP_BUFFER, n);
+    auto *run_stack = arena->get<sort_lib::RunStack>(STATE_BUFFER, 1);
+
+    // Duplicate the input data
+    memcpy(data_copy, data, n * sizeof(int));
+    memset(run_stack, 0, sizeof(sort_lib::RunStack));
+
+    // Call the sort function once, with the counters of the merges: the counts do not depend on the machine
+    sort_lib::tim_sort<true>(data_copy, n, temp_arr, run_stack, std::less<>(), policy);
+    *comparisons = run_stack->state.comparisons;
+    *moves = run_stack->state.moves;
 }
 
-// TimSort function that sorts the array using the provided temporary array and
-// run stack.
-void tim_sort(int arr[], const int n, int *temp_arr, RunStack *run_stack) {
-    if (n < MIN_MERGE) {
-        // For very small arrays, use insertion sort directly.
-        insertion_sort(arr, 0, n - 1);
+// Function to write the operation counts to a CSV file
+void write_counts_to_csv(const std::string &filename, const std::vector<CountResult> &runs) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
         return;
     }
-    // Calculate the minimum run length.
-    const int minrun = calculate_minrun(n);
-
-    run_stack->num_runs = 0;
-    int start = 0;
-    // Divide the array into runs and sort them.
-    while (start < n) {
-        int end;
-        extend_run_and_sort(arr, start, &end, n, minrun);
-        // Push the run onto the stack.
-        push_run(run_stack, start, end - start + 1);
-        // Merge runs to maintain the stacking invariants.
-        merge_collapse(arr, run_stack, temp_arr);
-
-        start = end + 1;
-    }
-
-    // Merge any remaining runs on the stack.
-    while (run_stack->num_runs > 1) {
-        int m = run_stack->num_runs - 2;
-        if (m >= 0) {
-            merge_runs(arr, run_stack, m, m + 1, temp_arr);
-        }
-    }
-}
 
-// ------------------------ Benchmarking Code ------------------------
+    // Write header
+    file << "length,min_val,max_val,comparisons,moves" << std::endl;
+    file << std::fixed << std::setprecision(1);
 
-long long benchmark_algorithm(const int n, int data[]) {
-    // Pre allocate the memory to avoid the overhead of malloc
-    auto *data_copy = new int[n];
-    auto *temp_arr = new int[n];
-    auto *run_stack = new RunStack;
-
-    // Get the resolution of the clock
-    const auto min_time = get_minimum_time();
-
-    // Initialize the clock to measure the execution time
-    long long elapsed = 0;
-    // Measure the elapsed time
-    int i = 0; // Counter to measure the number of iterations
-    const time_point_t start = std::chrono::steady_clock::now(); // Start the clock
-    while (elapsed < min_time) { // Continue until the minimum time is reached
-        // Increment the counter
-        i++;
-
-        // Duplicate the input data
-        memcpy(data_copy, data, n * sizeof(int));
-        // Clear the run stack
-        memset(run_stack, 0, sizeof(RunStack));
-        // Clear the temporary array
-        memset(temp_arr, 0, n * sizeof(int));
-
-        // Call the sort function
-        tim_sort(data_copy, n, temp_arr, run_stack);
-        // Measure the elapsed time
-        time_point_t end = std::chrono::steady_clock::now();
-        elapsed = std::chrono::duration_cast<time_unit_t>(end - start).count();
+    // Write data rows
+    for (const auto &[min, max, length, comparisons, moves]: runs) {
+        file << length << "," << min << "," << max << "," << comparisons << "," << moves << std::endl;
     }
 
-    // Free the allocated memory
-    delete[] data_copy;
-    delete[] temp_arr;
-    delete run_stack;
-
-    // Compute the elapsed time in nanoseconds
-    return elapsed / i;
+    file.close();
 }
 
 // ------------------------ Main Function ------------------------
@@ -251,13 +139,24 @@ int main(int argc, char *argv[]) {
 
     // Pre allocate the memory
     auto *temp_arr = new int[n];
-    auto *run_stack = new RunStack;
+    auto *run_stack = new sort_lib::RunStack;
     // Initialize the arrays
     memset(temp_arr, 0, n * sizeof(int));
-    memset(run_stack, 0, sizeof(RunStack));
-
-    // Execute the sort algorithm
-    tim_sort(arr, n, temp_arr, run_stack);
+    memset(run_stack, 0, sizeof(sort_lib::RunStack));
+
+    // Select the merge policy
+    const sort_lib::MergePolicy policy = get_option(argc, argv, "policy", "timsort") == "powersort"
+                                                 ? sort_lib::POWERSORT_POLICY
+                                                 : sort_lib::TIMSORT_POLICY;
+
+    // Execute the sort algorithm, in parallel if a thread count is given
+    const int num_threads = std::stoi(get_option(argc, argv, "threads", "1"));
+    if (num_threads > 1) {
+        TaskPool pool(num_threads);
+        sort_lib::parallel_tim_sort(arr, n, temp_arr, &pool, std::less<>(), policy);
+    } else {
+        sort_lib::tim_sort(arr, n, temp_arr, run_stack, std::less<>(), policy);
+    }
 
     // Print the sorted array
     for (int i = 0; i < n; i++) {
@@ -270,40 +169,186 @@ int main(int argc, char *argv[]) {
 #else
 
 int main(const int argc, char *argv[]) {
-    set_cpu_affinity();
+    const std::vector<std::string> args = get_positional_arguments(argc, argv);
+
+    if (args.size() < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [length|max] [linear|exponential] [output_file]"
+                     " [--order=random|sorted|reversed|organ_pipe|nearly_sorted|shuffled_runs] [--seed=N]"
+                     " [--policy=timsort|powersort] [--count] [--threads=N] [--variant=chunks|merges]"
+                     " [--max-length=N] [--huge-pages] [--counters] [--timing=total|sort] [--cores=LIST]"
+                  << std::endl;
+        std::cerr << "       " << argv[0]
+                  << " merge [linear|exponential] [output_file] [--threads=N] [--max-length=N] [--huge-pages]"
+                     " [--counters] [--timing=total|sort] [--cores=LIST]"
+                  << std::endl;
+        return 1;
+    }
+
+    // Select the merge policy
+    const std::string policy = get_option(argc, argv, "policy", "timsort");
+    if (policy != "timsort" && policy != "powersort") {
+        std::cerr << "Unknown merge policy: " << policy << std::endl;
+        return 1;
+    }
+    const sort_lib::MergePolicy merge_policy =
+            policy == "powersort" ? sort_lib::POWERSORT_POLICY : sort_lib::TIMSORT_POLICY;
+
+    // Count the comparisons and moves of the merges instead of measuring the time
+    const bool count = has_flag(argc, argv, "count");
+
+    // The parallel sort runs on all the requested cores, so the process is not pinned to the first one
+    const std::string threads_option = get_option(argc, argv, "threads", "");
+    const bool parallel = !threads_option.empty();
+    const int num_threads = parallel ? std::stoi(threads_option) : 1;
+    if (parallel && count) {
+        std::cerr << "The operation counts are only available for the sequential sort" << std::endl;
+        return 1;
+    }
+
+    // Select what runs in parallel: the whole sort, or only the large merges of the sequential sort
+    const std::string variant = get_option(argc, argv, "variant", "chunks");
+    if (variant != "chunks" && variant != "merges") {
+        std::cerr << "Unknown variant: " << variant << std::endl;
+        return 1;
+    }
+    if (parallel) {
+        set_process_priority();
+    } else {
+        set_cpu_affinity();
+    }
 
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " [length|max] [linear|exponential] [output_file]" << std::endl;
+    // Select the order of the input data
+    const std::string order = get_option(argc, argv, "order", "random");
+    if (!is_valid_input_order(order)) {
+        std::cerr << "Unknown input order: " << order << std::endl;
         return 1;
     }
 
-    const std::string mode = argv[1];
+    // Generate the same input data as the other executables run with the same seed
+    const std::string seed = get_option(argc, argv, "seed", "");
+    if (!seed.empty()) {
+        set_input_seed(std::stoul(seed));
+    }
+
+    const std::string mode = args[1];
     const bool test_length = (mode == "length");
 
     // Default to exponential scaling if not specified
     bool linear_scaling = false;
-    if (argc >= 3) {
-        const std::string scaling_mode = argv[2];
+    if (args.size() >= 3) {
+        const std::string scaling_mode = args[2];
         linear_scaling = (scaling_mode == "linear");
     }
 
     // Output filename
     std::string output_file;
-    if (argc >= 4) {
-        output_file = argv[3];
+    if (args.size() >= 4) {
+        output_file = args[3];
     } else {
         // Generate a filename based on test parameters and timestamp
-        output_file = generate_filename(test_length ? "length" : "max", linear_scaling, "tim_sort");
+        std::string sort_type = parallel ? "parallel_tim_sort" : "tim_sort";
+        if (parallel && variant == "merges") {
+            sort_type = "tim_sort_parallel_merges";
+        }
+        if (policy != "timsort") {
+            sort_type += "_" + policy;
+        }
+        if (order != "random") {
+            sort_type += "_" + order;
+        }
+        if (count) {
+            sort_type += "_counts";
+        }
+        output_file = generate_filename(mode == "merge" ? mode : test_length ? "length" : "max", linear_scaling,
+                                        sort_type);
+    }
+
+    // Create the pool once, so that the threads are not started in the timed loop
+    TaskPool pool(num_threads);
+    const bool huge_pages = has_flag(argc, argv, "huge-pages");
+
+    // Count the hardware events of the timed loops if requested
+    if (has_flag(argc, argv, "counters")) {
+        // The counters only follow the calling thread, they would miss the work of the other threads of the pool
+        if (parallel) {
+            std::cerr << "The hardware counters only count the calling thread, --counters cannot be used with --threads"
+                      << std::endl;
+            return 1;
+        }
+        enable_perf_counters();
+    }
+
+    // Select whether the timed loops measure the copies of the input or only the sorts
+    const std::string timing = get_option(argc, argv, "timing", "total");
+    TimingMode timing_mode;
+    if (!parse_timing_mode(timing, &timing_mode)) {
+        std::cerr << "Unknown timing mode: " << timing << std::endl;
+        return 1;
+    }
+    set_timing_mode(timing_mode);
+
+    // Shard the sample points across worker processes pinned to the given cores, if any
+    const std::string cores_option = get_option(argc, argv, "cores", "");
+    std::vector<int> cores;
+    if (!parse_core_list(cores_option, &cores)) {
+        std::cerr << "Invalid list of cores: " << cores_option << std::endl;
+        return 1;
+    }
+    if (parallel && !cores.empty()) {
+        std::cerr << "The workers of --cores are single-threaded, --threads cannot be used with --cores" << std::endl;
+        return 1;
+    }
+
+    // Micro-benchmark of the merge of two sorted halves, sequential or on the pool
+    if (mode == "merge") {
+        std::vector<RunResult> runs;
+        const int max_length = std::stoi(get_option(argc, argv, "max-length", std::to_string(MERGE_MAX_LENGTH)));
+        // Allocate the buffers once for the largest arrays of the sweep
+        BenchmarkArena arena(max_length * sizeof(int), huge_pages);
+        const std::vector<int> merge_points =
+                generate_sample_points(MERGE_MIN_LENGTH, max_length, MERGE_SAMPLES, linear_scaling);
+        const bool completed = run_sweep(merge_points, cores, &runs, [&](const int length) {
+            RunResult run = {};
+            run.max = 1000000;
+            run.length = length;
+
+            // Generate the two sorted halves once, the merge does not modify them
+            const auto data = arena.get<int>(INPUT_BUFFER, run.length);
+            generate_input_data(data, run.length, run.min, run.max);
+            std::sort(data, data + run.length / 2);
+            std::sort(data + run.length / 2, data + run.length);
+
+            // Run multiple times for each sample point
+            for (int r = 0; r < NUM_RUNS; r++) {
+                run.time[r] = benchmark_merge(run.length, data, &arena, parallel ? &pool : nullptr);
+                add_perf_counters(&run);
+                add_copy_time(&run);
+            }
+
+            // Print results for this run
+            std::cout << "Length: " << run.length << ", Min: " << run.min << ", Max: " << run.max << std::endl;
+
+            return run;
+        });
+        if (!completed) {
+            return 1;
+        }
+
+        // Write results to CSV file
+        write_results_to_csv(output_file, runs);
+        return 0;
     }
 
     std::vector<RunResult> runs;
+    std::vector<CountResult> counts;
 
     // Determine which parameter to vary and its range
     int min_param, max_param;
     bool vary_length;
     if (test_length) {
         min_param = 100; // min_length
-        max_param = 100000; // max_length
+        max_param = std::stoi(get_option(argc, argv, "max-length", "100000")); // max_length
         vary_length = true;
     } else {
         min_param = 10; // min_max
@@ -314,8 +359,12 @@ int main(const int argc, char *argv[]) {
     // Generate sample points based on scaling type
     std::vector<int> sample_points = generate_sample_points(min_param, max_param, NUM_SAMPLES, linear_scaling);
 
-    // Run tests for each sample point
-    for (const int param_value: sample_points) {
+    // Allocate the buffers once for the largest arrays of the sweep
+    BenchmarkArena arena((vary_length ? max_param : 100000) * sizeof(int), huge_pages);
+
+    // Run tests for each sample point, sharded across the cores if requested
+    std::vector<SweepResult> results;
+    const bool completed = run_sweep(sample_points, cores, &results, [&](const int param_value) {
         RunResult run = {};
 
         if (vary_length) {
@@ -326,25 +375,53 @@ int main(const int argc, char *argv[]) {
             run.length = 100000;
         }
 
+        CountResult count_result = {run.min, run.max, run.length, 0, 0};
+
         // Run multiple times for each sample point
         for (int r = 0; r < NUM_RUNS; r++) {
             // Generate input data with appropriate parameters
-            const auto data = new int[run.length];
+            const auto data = arena.get<int>(INPUT_BUFFER, run.length);
             generate_input_data(data, run.length, run.min, run.max);
-            // Execute and record time
-            run.time[r] = benchmark_algorithm(run.length, data);
-            // Free the allocated memory
-            delete[] data;
+            arrange_input_data(data, run.length, order);
+            if (count) {
+                // Execute and record the operation counts
+                long long comparisons, moves;
+                count_algorithm(run.length, data, &arena, merge_policy, &comparisons, &moves);
+                count_result.comparisons += static_cast<double>(comparisons) / NUM_RUNS;
+                count_result.moves += static_cast<double>(moves) / NUM_RUNS;
+            } else {
+                // Execute and record time
+                if (!parallel) {
+                    run.time[r] = benchmark_algorithm(run.length, data, &arena, merge_policy);
+                } else if (variant == "merges") {
+                    run.time[r] = benchmark_algorithm(run.length, data, &arena, merge_policy, &pool);
+                } else {
+                    run.time[r] = benchmark_parallel_algorithm(run.length, data, &arena, &pool, merge_policy);
+                }
+                add_perf_counters(&run);
+                add_copy_time(&run);
+            }
         }
 
         // Print results for this run
         std::cout << "Length: " << run.length << ", Min: " << run.min << ", Max: " << run.max << std::endl;
 
-        runs.push_back(run);
+        return SweepResult{run, count_result};
+    });
+    if (!completed) {
+        return 1;
+    }
+    for (const SweepResult &result: results) {
+        runs.push_back(result.run);
+        counts.push_back(result.counts);
     }
 
     // Write results to CSV file
-    write_results_to_csv(output_file, runs);
+    if (count) {
+        write_counts_to_csv(output_file, counts);
+    } else {
+        write_results_to_csv(output_file, runs);
+    }
 
     return 0;
 }
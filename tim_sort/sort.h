@@ -1,123 +1,91 @@
 #ifndef TIM_SORT_H
 #define TIM_SORT_H
 
+#include <string>
+#include <vector>
 
-// Threshold for switching to insertion sort.
-constexpr int THRESHOLD = 64;
-// The minimum size to enable the tim sort algorithm.
-constexpr int MIN_MERGE = 32;
+#include "arena.h"
+#include "task_pool.h"
+#include "tim_sort.h"
+#include "utils.h"
 
-// The maximum number of pending runs on the stack.
-// This needs to be large enough to handle worst-case scenarios but small enough
-// to fit in cache.
-constexpr int MAX_PENDING_RUNS = 85;
+// Range and number of sample points of the merge micro-benchmark.
+constexpr int MERGE_MIN_LENGTH = 1000000;
+constexpr int MERGE_MAX_LENGTH = 100000000;
+constexpr int MERGE_SAMPLES = 16;
 
 
 /**
- * @brief Structure to store a run of elements in the array.
+ * @brief Structure to store the operation counts of a benchmark run.
  */
-struct Run_t {
-    int start; // Start index of the run.
-    int length; // Length of the run.
-} typedef Run;
+struct CountResult_t {
+    int min; // Minimum value of the array
+    int max; // Maximum value of the array
+    int length; // Length of the array
+    double comparisons; // Average number of comparisons made by the merges
+    double moves; // Average number of elements moved by the merges
+} typedef CountResult;
 
 /**
- * @brief Structure to store the stack of runs.
+ * @brief Structure to store the results of a sample point of the sweep, its times or its operation counts.
  */
-struct RunStack_t {
-    Run stack[MAX_PENDING_RUNS];
-    int num_runs; // Number of runs currently on the stack.
-} typedef RunStack;
-
-
-/**
- * @brief Sort the array using the insertion sort algorithm.
- * @param arr The array to sort
- * @param left The left index of the array
- * @param right The right index of the array
- */
-void insertion_sort(int arr[], int left, int right);
-
-/**
- * @brief Merge two sorted subarrays into a single sorted array.
- * @param arr The array to merge
- * @param left The left index of the first subarray
- * @param mid The right index of the first subarray and the left index of the second subarray
- * @param right The right index of the second subarray
- * @param temp_arr The temporary array to store the merged array
- */
-void merge(int arr[], int left, int mid, int right, int *temp_arr);
+struct SweepResult_t {
+    RunResult run; // Execution times of the runs
+    CountResult counts; // Operation counts of the runs, with --count
+} typedef SweepResult;
 
 /**
- * @brief Calculate the minimum run length for the array.
+ * Execute the sort algorithm
  * @param n The length of the array
- * @return The minimum run length
+ * @param data The array of integers
+ * @param arena The buffers of the benchmark
+ * @param policy The merge policy
+ * @param pool The pool that executes the large merges, or nullptr
+ * @return The execution time in nanoseconds
  */
-int calculate_minrun(int n);
+long long benchmark_algorithm(int n, int data[], BenchmarkArena *arena,
+                              sort_lib::MergePolicy policy = sort_lib::TIMSORT_POLICY, TaskPool *pool = nullptr);
 
 /**
- * @brief Count the length of a naturally occurring run in the array starting at 'start'.
- * A run is a sequence of elements that are either non-decreasing or strictly decreasing.
- * @param arr The array to count the run
- * @param start The start index of the run
+ * Execute the merge of the two sorted halves of the array
  * @param n The length of the array
- * @return The length of the run
+ * @param data The array of integers, whose halves data[0:n/2] and data[n/2:n] are sorted
+ * @param arena The buffers of the benchmark
+ * @param pool The pool that executes parallel_merge, or nullptr to execute merge on the calling thread
+ * @return The execution time in nanoseconds
  */
-int count_run(int arr[], int start, int n);
+long long benchmark_merge(int n, int data[], BenchmarkArena *arena, TaskPool *pool);
 
 /**
- * @brief Extend the run to the maximum possible length and sort it using the insertion sort algorithm.
- * @param arr The array to sort
- * @param start The start index of the run
- * @param end The end index of the run
+ * Execute the parallel sort algorithm
  * @param n The length of the array
- * @param min_run The minimum run length
- */
-void extend_run_and_sort(int arr[], int start, int *end, int n, int min_run);
-
-/**
- * @brief Push a run onto the stack of runs.
- * @param stack The stack of runs
- * @param start The start index of the run
- * @param length The length of the run
- */
-void push_run(RunStack *stack, int start, int length);
-
-/**
- * @brief Merge runs on the stack
- * @param arr The array to sort
- * @param stack The stack of runs
- * @param temp_arr The temporary array to store the merged array
- */
-void merge_collapse(int arr[], RunStack *stack, int *temp_arr);
-
-/**
- * @brief Merge two runs on the stack at indices a and b.
- * Used by the merge_collapse function. This should not be called directly or the stack invariants may be violated.
- * @param arr The array to sort
- * @param stack The stack of runs
- * @param left The index of the first run
- * @param right The index of the second run
- * @param temp_arr The temporary array to store the merged array
+ * @param data The array of integers
+ * @param arena The buffers of the benchmark
+ * @param pool The pool that executes the sort
+ * @param policy The merge policy
+ * @return The execution time in nanoseconds
  */
-void merge_runs(int arr[], RunStack *stack, int left, int right, int *temp_arr);
+long long benchmark_parallel_algorithm(int n, int data[], BenchmarkArena *arena, TaskPool *pool,
+                                       sort_lib::MergePolicy policy);
 
 /**
- * @brief Sort the array using the TimSort algorithm.
- * @param arr The array to sort
+ * Count the comparisons and element moves made by the merges of the sort algorithm
  * @param n The length of the array
- * @param temp_arr The temporary array to store the merged array
- * @param run_stack The stack of runs
+ * @param data The array of integers
+ * @param arena The buffers of the benchmark
+ * @param policy The merge policy
+ * @param comparisons The number of comparisons
+ * @param moves The number of elements moved
  */
-void tim_sort(int arr[], int n, int *temp_arr, RunStack *run_stack);
+void count_algorithm(int n, const int data[], BenchmarkArena *arena, sort_lib::MergePolicy policy,
+                     long long *comparisons, long long *moves);
 
 /**
- * Execute the sort algorithm
- * @param n The length of the array
- * @param data The array of integers
- * @return The execution time in nanoseconds
+ * @brief Write the operation counts to a CSV file
+ * @param filename the name of the file
+ * @param runs the operation counts of the runs
  */
-long long benchmark_algorithm(int n, int data[]);
+void write_counts_to_csv(const std::string &filename, const std::vector<CountResult> &runs);
 
 /**
  * Main function to run the sort algorithm
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#include "arena.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/mman.h> // mmap, madvise
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+// Get the size of the pages of the system
+static size_t page_size() {
+#if defined(__linux__) || defined(__APPLE__)
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 4096;
+#endif
+}
+
+#if defined(__linux__)
+
+// Map memory backed by huge pages, or return nullptr
+static void *map_huge_pages(const size_t bytes) {
+    // Explicit huge pages are only available if the system has reserved some (vm.nr_hugepages)
+    void *data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED) {
+        return data;
+    }
+
+    static bool warned = false;
+    if (!warned) {
+        std::cerr << "No explicit huge pages available, using transparent huge pages" << std::endl;
+        warned = true;
+    }
+
+    // Map one more huge page to align the buffer to a huge page, then unmap the unaligned head and the tail
+    const size_t length = bytes + HUGE_PAGE_SIZE;
+    auto *region = static_cast<char *>(
+        mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (region == MAP_FAILED) {
+        return nullptr;
+    }
+    const auto address = reinterpret_cast<uintptr_t>(region);
+    auto *aligned = region + ((HUGE_PAGE_SIZE - address % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE);
+    if (aligned > region) {
+        munmap(region, aligned - region);
+    }
+    if (aligned + bytes < region + length) {
+        munmap(aligned + bytes, region + length - (aligned + bytes));
+    }
+    madvise(aligned, bytes, MADV_HUGEPAGE);
+    return aligned;
+}
+
+#endif
+
+// Map memory of the given size, a multiple of the page size
+static void *map_memory(const size_t bytes, const bool huge_pages) {
+#if defined(__linux__)
+    if (huge_pages) {
+        return map_huge_pages(bytes);
+    }
+#endif
+
+#if defined(__linux__) || defined(__APPLE__)
+    void *data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return data == MAP_FAILED ? nullptr : data;
+#elif defined(_WIN32)
+    return VirtualAlloc(nullptr, bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+    return std::malloc(bytes);
+#endif
+}
+
+// Unmap memory returned by map_memory
+static void unmap_memory(void *data, const size_t bytes) {
+#if defined(__linux__) || defined(__APPLE__)
+    munmap(data, bytes);
+#elif defined(_WIN32)
+    VirtualFree(data, 0, MEM_RELEASE);
+#else
+    std::free(data);
+#endif
+}
+
+BenchmarkArena::BenchmarkArena(const size_t reserve_bytes, const bool huge_pages)
+    : blocks(NUM_ARENA_BUFFERS, Block{nullptr, 0}), reserve_bytes(reserve_bytes), huge_pages(huge_pages) {
+#if !defined(__linux__)
+    if (huge_pages) {
+        std::cerr << "Huge pages are only supported on Linux" << std::endl;
+        this->huge_pages = false;
+    }
+#endif
+}
+
+BenchmarkArena::~BenchmarkArena() {
+    for (const Block &block: blocks) {
+        if (block.data != nullptr) {
+            unmap_memory(block.data, block.capacity);
+        }
+    }
+}
+
+void *BenchmarkArena::get_bytes(const int buffer, const size_t bytes) {
+    if (buffer >= static_cast<int>(blocks.size())) {
+        blocks.resize(buffer + 1, Block{nullptr, 0});
+    }
+
+    Block &block = blocks[buffer];
+    if (block.data != nullptr && bytes <= block.capacity) {
+        return block.data;
+    }
+
+    // Grow geometrically, so that a sweep of increasing lengths grows a buffer a logarithmic number of times
+    const size_t page = huge_pages ? HUGE_PAGE_SIZE : page_size();
+    size_t capacity = std::max({bytes, reserve_bytes, 2 * block.capacity, static_cast<size_t>(1)});
+    capacity = (capacity + page - 1) / page * page;
+
+    if (block.data != nullptr) {
+        unmap_memory(block.data, block.capacity);
+        block = Block{nullptr, 0};
+    }
+    void *data = map_memory(capacity, huge_pages);
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    // Write every page, so that the timed loops do not take the page faults of the first accesses
+    memset(data, 0, capacity);
+
+    block = Block{data, capacity};
+    return data;
+}
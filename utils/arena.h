@@ -0,0 +1,84 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// Size of the huge pages backing the buffers of an arena created with huge pages.
+constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+
+/**
+ * @brief Buffers of a BenchmarkArena
+ */
+enum ArenaBuffer_t {
+    INPUT_BUFFER, // Input data generated for a run
+    COPY_BUFFER, // Copy of the input sorted by an iteration of the timed loop
+    TEMP_BUFFER, // Temporary array of the algorithm
+    OUT_BUFFER, // Output array of the algorithm
+    COUNT_BUFFER, // Count array of the algorithm
+    STATE_BUFFER, // Fixed-size state of the algorithm, e.g. the run stack of tim_sort
+    NUM_ARENA_BUFFERS, // Number of the buffers above, executables number their own buffers from here
+} typedef ArenaBuffer;
+
+/**
+ * @brief Buffers of a benchmark, allocated once and reused by every run of the sweep
+ *
+ * A buffer only grows, to at least the reserved size and at least twice its previous capacity, and every page of a
+ * new buffer is written before it is returned. The runs and the timed loops therefore neither allocate memory nor
+ * take the page faults of freshly mapped memory.
+ */
+class BenchmarkArena {
+public:
+    /**
+     * @brief Create the arena, the buffers are allocated on their first use
+     * @param reserve_bytes The minimum capacity of a buffer, the size of the largest array of the sweep
+     * @param huge_pages true to back the buffers with huge pages: explicit huge pages if the system has reserved
+     * some, transparent huge pages otherwise
+     */
+    BenchmarkArena(size_t reserve_bytes, bool huge_pages);
+
+    /**
+     * @brief Release all the buffers
+     */
+    ~BenchmarkArena();
+
+    BenchmarkArena(const BenchmarkArena &) = delete;
+    BenchmarkArena &operator=(const BenchmarkArena &) = delete;
+
+    /**
+     * @brief Get a buffer of at least count elements
+     * @param buffer The buffer, an ArenaBuffer or a number chosen by the executable
+     * @param count The number of elements
+     * @return The buffer; its content is kept unless it has to grow, and a grown buffer is zeroed
+     */
+    template <class T>
+    T *get(const int buffer, const long long count) {
+        static_assert(std::is_trivially_copyable<T>::value, "The arena holds trivially copyable elements only");
+        return static_cast<T *>(get_bytes(buffer, static_cast<size_t>(count) * sizeof(T)));
+    }
+
+    /**
+     * @brief Get a buffer of at least the given size
+     * @param buffer The buffer, an ArenaBuffer or a number chosen by the executable
+     * @param bytes The size in bytes
+     * @return The buffer, aligned to a page
+     * @throws std::bad_alloc if the buffer cannot be allocated
+     */
+    void *get_bytes(int buffer, size_t bytes);
+
+private:
+    /**
+     * @brief Memory of a buffer
+     */
+    struct Block_t {
+        void *data; // Start of the buffer, nullptr until its first use
+        size_t capacity; // Size of the buffer in bytes
+    } typedef Block;
+
+    std::vector<Block> blocks; // Buffers, indexed by their number
+    size_t reserve_bytes; // Minimum capacity of a buffer
+    bool huge_pages; // Whether the buffers are backed by huge pages
+};
+
+#endif
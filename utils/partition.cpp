@@ -0,0 +1,115 @@
+#include <functional>
+#include <string>
+
+#include "partition.h"
+#include "quick_3way_sort.h"
+#include "utils.h"
+
+// 3-way partition function
+void partition_3way(int *a, const int i, const int j, int *k, int *l) {
+    sort_lib::partition_3way(a, i, j, k, l, std::less<>());
+}
+
+// Bentley-McIlroy 3-way partition function
+void bentley_mcilroy_partition_3way(int *a, const int i, const int j, int *k, int *l) {
+    sort_lib::partition_bentley_mcilroy(a, i, j, k, l, std::less<>());
+}
+
+// Block partition function (BlockQuicksort, Edelkamp and Weiss)
+int block_partition(int *a, const int i, const int j) {
+    const int pivot = a[j - 1]; // Choose the last element as the pivot
+
+    // Offsets of the misplaced elements of the current left and right blocks
+    unsigned char offsets_l[PARTITION_BLOCK_SIZE];
+    unsigned char offsets_r[PARTITION_BLOCK_SIZE];
+    int num_l = 0, num_r = 0; // Number of offsets still to be swapped
+    int start_l = 0, start_r = 0; // Index of the first offset still to be swapped
+
+    // Elements in [i, l) are <= pivot, elements in [r, j - 1) are > pivot
+    int l = i;
+    int r = j - 1;
+
+    while (r - l >= 2 * PARTITION_BLOCK_SIZE) {
+        // Fill the left buffer with the offsets of the elements greater than the pivot
+        if (num_l == 0) {
+            start_l = 0;
+            for (int k = 0; k < PARTITION_BLOCK_SIZE; k++) {
+                offsets_l[num_l] = static_cast<unsigned char>(k);
+                num_l += (a[l + k] > pivot);
+            }
+        }
+
+        // Fill the right buffer with the offsets of the elements less than or equal to the pivot
+        if (num_r == 0) {
+            start_r = 0;
+            for (int k = 0; k < PARTITION_BLOCK_SIZE; k++) {
+                offsets_r[num_r] = static_cast<unsigned char>(k);
+                num_r += (a[r - 1 - k] <= pivot);
+            }
+        }
+
+        // Swap the misplaced elements pairwise
+        const int num = num_l < num_r ? num_l : num_r;
+        for (int k = 0; k < num; k++) {
+            swap(a, l + offsets_l[start_l + k], r - 1 - offsets_r[start_r + k]);
+        }
+        num_l -= num;
+        num_r -= num;
+        start_l += num;
+        start_r += num;
+
+        // Move past the blocks that do not contain misplaced elements anymore
+        if (num_l == 0) {
+            l += PARTITION_BLOCK_SIZE;
+        }
+        if (num_r == 0) {
+            r -= PARTITION_BLOCK_SIZE;
+        }
+    }
+
+    // Partition the remaining elements, including the pending offsets of the last block,
+    // with a branchless Lomuto loop
+    int k = l;
+    for (int m = l; m < r; m++) {
+        const int value = a[m];
+        a[m] = a[k];
+        a[k] = value;
+        k += (value <= pivot);
+    }
+
+    // Move the pivot between the two partitions
+    swap(a, k, j - 1);
+    return k;
+}
+
+// Function to get a partition function by name
+PartitionFunction get_partition_function(const std::string &name, const PartitionFunction lomuto) {
+    if (name == "lomuto") {
+        return lomuto;
+    }
+    if (name == "block") {
+        return block_partition;
+    }
+    if (name == "simd") {
+        return simd_partition;
+    }
+    return nullptr;
+}
+
+// Function to get a pivot policy by name
+bool parse_pivot_policy(const std::string &name, PivotPolicy *policy) {
+    if (name == "last") {
+        *policy = LAST_PIVOT;
+    } else if (name == "random") {
+        *policy = RANDOM_PIVOT;
+    } else if (name == "median3") {
+        *policy = MEDIAN_OF_3_PIVOT;
+    } else if (name == "ninther") {
+        *policy = NINTHER_PIVOT;
+    } else if (name == "median_of_medians") {
+        *policy = MEDIAN_OF_MEDIANS_PIVOT;
+    } else {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,220 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <string>
+
+#include "pivot.h"
+
+// Number of elements classified at once by the block partition.
+// The offsets of a block are stored in unsigned chars, so it must not exceed 256.
+constexpr int PARTITION_BLOCK_SIZE = 128;
+
+/**
+ * @brief Signature of a partition function used by the quick sorts
+ *
+ * A partition function uses a[j - 1] as the pivot and rearranges a[i:j] (j exclusive) so that
+ * the elements less than or equal to the pivot are on its left and the greater ones on its right.
+ * It returns the final index of the pivot.
+ */
+typedef int (*PartitionFunction)(int *a, int i, int j);
+
+/**
+ * @brief Signature of a 3-way partition function used by the 3-way quick sort
+ *
+ * A 3-way partition function uses a[j - 1] as the pivot and rearranges a[i:j] (j exclusive) so that
+ * [i, k) contains the elements less than the pivot, [k, l) the elements equal to the pivot and
+ * [l, j) the elements greater than the pivot.
+ */
+typedef void (*Partition3WayFunction)(int *a, int i, int j, int *k, int *l);
+
+/**
+ * @brief Signature of a vector partition kernel
+ *
+ * A kernel moves the elements of a[0:n] (n exclusive) less than or equal to the pivot before the greater
+ * ones and returns the number of elements less than or equal to the pivot.
+ */
+typedef int (*SimdKernelFunction)(int *a, int n, int pivot);
+
+/**
+ * @brief Partition of the sort_lib quick sorts that calls a PartitionFunction
+ *
+ * The comparator is ignored: the partition functions of this file order the elements with <=.
+ */
+struct PartitionCaller_t {
+    PartitionFunction fn; // The partition function to call
+
+    template <class Compare>
+    int operator()(int *a, const int i, const int j, Compare) const {
+        return fn(a, i, j);
+    }
+} typedef PartitionCaller;
+
+/**
+ * @brief 3-way partition of the sort_lib 3-way quick sort that calls a Partition3WayFunction
+ *
+ * The comparator is ignored: the partition functions of this file order the elements with < and ==.
+ */
+struct Partition3WayCaller_t {
+    Partition3WayFunction fn; // The 3-way partition function to call
+
+    template <class Compare>
+    void operator()(int *a, const int i, const int j, int *k, int *l, Compare) const {
+        fn(a, i, j, k, l);
+    }
+} typedef Partition3WayCaller;
+
+/**
+ * @brief Pivot policy of the quick sorts, selected at runtime (see sort_lib/pivot.h)
+ */
+enum PivotPolicy_t {
+    LAST_PIVOT, // sort_lib::LastPivot
+    RANDOM_PIVOT, // sort_lib::RandomPivot
+    MEDIAN_OF_3_PIVOT, // sort_lib::MedianOf3Pivot
+    NINTHER_PIVOT, // sort_lib::NintherPivot
+    MEDIAN_OF_MEDIANS_PIVOT, // sort_lib::MedianOfMediansPivot
+} typedef PivotPolicy;
+
+/**
+ * @brief Call fn with the sort_lib pivot policy of the given kind
+ *
+ * The policies are template parameters of the sorts, so every policy instantiates its own sort.
+ * The random policy is seeded with sort_lib::DEFAULT_RANDOM_SEED, so every run selects the same pivots.
+ *
+ * @param policy The pivot policy
+ * @param fn The callable, called with the policy as its only argument
+ */
+template <class Function>
+void with_pivot_policy(const PivotPolicy policy, Function fn) {
+    if (policy == RANDOM_PIVOT) {
+        fn(sort_lib::RandomPivot<>());
+    } else if (policy == MEDIAN_OF_3_PIVOT) {
+        fn(sort_lib::MedianOf3Pivot());
+    } else if (policy == NINTHER_PIVOT) {
+        fn(sort_lib::NintherPivot());
+    } else if (policy == MEDIAN_OF_MEDIANS_PIVOT) {
+        fn(sort_lib::MedianOfMediansPivot());
+    } else {
+        fn(sort_lib::LastPivot());
+    }
+}
+
+/**
+ * @brief Get the pivot policy with the given name
+ * @param name "last", "random", "median3", "ninther" or "median_of_medians"
+ * @param policy The pivot policy, set if the name is known
+ * @return true if the name is known
+ */
+bool parse_pivot_policy(const std::string &name, PivotPolicy *policy);
+
+/**
+ * @brief Partitions the array into three parts for the 3-way quick sort (sort_lib::partition_3way on int).
+ *
+ * This function partitions the subarray a[i...j-1] into three parts:
+ * - Elements less than the pivot.
+ * - Elements equal to the pivot.
+ * - Elements greater than the pivot.
+ *
+ * The pivot is chosen as the last element of the subarray (a[j-1]). It rearranges
+ * the elements so that [i, k) contains elements less than the pivot, [k, l) contains
+ * elements equal to the pivot, and [l, j) contains elements greater than the pivot.
+ *
+ * @param a Pointer to the array of integers.
+ * @param i Starting index of the subarray.
+ * @param j One past the last index of the subarray.
+ * @param k Pointer to store the starting index of the equal-to-pivot region.
+ * @param l Pointer to store the ending index (exclusive) of the equal-to-pivot region.
+ */
+void partition_3way(int *a, int i, int j, int *k, int *l);
+
+/**
+ * @brief Partitions the array into three parts with the Bentley-McIlroy fat partition
+ * (sort_lib::partition_bentley_mcilroy on int).
+ *
+ * Same result as partition_3way. The subarray is scanned from both ends, the elements equal to the pivot are
+ * kept at the two ends during the scans and swapped to the middle at the end.
+ *
+ * @param a Pointer to the array of integers.
+ * @param i Starting index of the subarray.
+ * @param j One past the last index of the subarray.
+ * @param k Pointer to store the starting index of the equal-to-pivot region.
+ * @param l Pointer to store the ending index (exclusive) of the equal-to-pivot region.
+ */
+void bentley_mcilroy_partition_3way(int *a, int i, int j, int *k, int *l);
+
+/**
+ * @brief Partitions the array without data-dependent branches (BlockQuicksort)
+ *
+ * The subarray is scanned from both ends in blocks of PARTITION_BLOCK_SIZE elements. For each block the
+ * offsets of the misplaced elements (greater than the pivot on the left, less than or equal on the right)
+ * are stored into a buffer by adding the result of the comparison to the buffer length, instead of branching
+ * on it. Then the misplaced elements of the two blocks are swapped pairwise. The remaining elements in the
+ * middle are partitioned with a branchless Lomuto loop.
+ * The result is the same partition produced by the Lomuto partition: the pivot is the last element,
+ * elements less than or equal to it are placed on its left.
+ *
+ * @param a Pointer to the array of integers.
+ * @param i Starting index of the subarray.
+ * @param j Ending index of the subarray (exclusive).
+ * @return int The final index position of the pivot after partitioning.
+ */
+int block_partition(int *a, int i, int j);
+
+/**
+ * @brief Moves the elements less than or equal to the pivot to the front of the array
+ *
+ * Dispatches to the widest kernel supported by the CPU, selected on the first call:
+ * AVX-512 (16 elements per step, compress-stores), AVX2 (8 elements per step, permutation table)
+ * or a scalar branchless loop.
+ * The vector kernels keep the first and the last vector in registers, so that every step can store the
+ * elements less than or equal to the pivot at the left end and the greater ones at the right end in place.
+ *
+ * @param a Pointer to the array of integers.
+ * @param n Length of the array.
+ * @param pivot The value used to split the array.
+ * @return int The number of elements less than or equal to the pivot.
+ */
+int simd_partition_le(int *a, int n, int pivot);
+
+/**
+ * @brief Get the name of the kernel used by simd_partition_le on this CPU
+ * @return "avx512", "avx2" or "scalar"
+ */
+const char *simd_partition_kernel_name();
+
+/**
+ * @brief Partitions the array with the vector kernel
+ *
+ * Same result as the Lomuto partition: the pivot is the last element, elements less than or equal
+ * to it are placed on its left.
+ *
+ * @param a Pointer to the array of integers.
+ * @param i Starting index of the subarray.
+ * @param j Ending index of the subarray (exclusive).
+ * @return int The final index position of the pivot after partitioning.
+ */
+int simd_partition(int *a, int i, int j);
+
+/**
+ * @brief Partitions the array into three parts with the vector kernel
+ *
+ * The first pass splits the elements less than or equal to the pivot from the greater ones, the second
+ * pass splits the first part into the elements less than the pivot and the elements equal to it.
+ * The pivot is the last element of the subarray.
+ *
+ * @param a Pointer to the array of integers.
+ * @param i Starting index of the subarray.
+ * @param j One past the last index of the subarray.
+ * @param k Pointer to store the starting index of the equal-to-pivot region.
+ * @param l Pointer to store the ending index (exclusive) of the equal-to-pivot region.
+ */
+void simd_partition_3way(int *a, int i, int j, int *k, int *l);
+
+/**
+ * @brief Get the partition function with the given name
+ * @param name "lomuto", "block" or "simd"
+ * @param lomuto The Lomuto partition function of the executable, returned for "lomuto"
+ * @return the partition function, or nullptr if the name is unknown
+ */
+PartitionFunction get_partition_function(const std::string &name, PartitionFunction lomuto);
+
+#endif
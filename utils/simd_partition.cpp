@@ -0,0 +1,226 @@
+#include <climits>
+
+#include "partition.h"
+#include "utils.h"
+
+// The vector kernels are compiled only for x86-64 with GCC or Clang, which can enable the
+// instruction sets per function, so the rest of the project does not depend on -mavx2/-mavx512f.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SIMD_PARTITION_X86
+#include <immintrin.h>
+#endif
+
+// Partition n elements stored in tmp into a[left:right] (right exclusive, right - left == n):
+// elements less than or equal to the pivot from the left, the greater ones from the right.
+// Returns the index of the first element greater than the pivot.
+static int distribute(int *a, int left, int right, const int tmp[], const int n, const int pivot) {
+    for (int m = 0; m < n; m++) {
+        if (tmp[m] <= pivot) {
+            a[left++] = tmp[m];
+        } else {
+            a[--right] = tmp[m];
+        }
+    }
+    return left;
+}
+
+// Scalar kernel: branchless Lomuto loop
+static int partition_le_scalar(int *a, const int n, const int pivot) {
+    int k = 0;
+    for (int m = 0; m < n; m++) {
+        const int value = a[m];
+        a[m] = a[k];
+        a[k] = value;
+        k += (value <= pivot);
+    }
+    return k;
+}
+
+#ifdef SIMD_PARTITION_X86
+
+// For each 8-bit mask of the elements greater than the pivot, the permutation that moves the elements
+// less than or equal to the pivot to the front and the greater ones to the back of an AVX2 vector.
+struct PermutationTable_t {
+    alignas(32) int index[256][8];
+
+    PermutationTable_t() : index() {
+        for (int mask = 0; mask < 256; mask++) {
+            int low = 0;
+            int high = 7;
+            for (int b = 0; b < 8; b++) {
+                if (mask & (1 << b)) {
+                    index[mask][high--] = b;
+                } else {
+                    index[mask][low++] = b;
+                }
+            }
+        }
+    }
+};
+
+static const PermutationTable_t permutation_table;
+
+// AVX2 kernel: 8 elements per step, reordered with the permutation table and stored at both ends
+__attribute__((target("avx2,popcnt"))) static int partition_le_avx2(int *a, const int n, const int pivot) {
+    constexpr int W = 8;
+    if (n < 2 * W) {
+        return partition_le_scalar(a, n, pivot);
+    }
+
+    const __m256i pivot_vec = _mm256_set1_epi32(pivot);
+
+    // Buffer the first and the last vector to make room for the stores at both ends
+    const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a));
+    const __m256i last = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + n - W));
+
+    int l = W, r = n - W; // Elements in [l, r) have not been read yet
+    int left = 0, right = n; // Elements in [0, left) are <= pivot, elements in [right, n) are > pivot
+
+    while (r - l >= W) {
+        // Read from the side with less free space, so that both sides have room for a whole vector
+        __m256i v;
+        if (l - left <= right - r) {
+            v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + l));
+            l += W;
+        } else {
+            r -= W;
+            v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + r));
+        }
+
+        const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, pivot_vec)));
+        const __m256i perm = _mm256_load_si256(reinterpret_cast<const __m256i *>(permutation_table.index[mask]));
+        const __m256i sorted = _mm256_permutevar8x32_epi32(v, perm);
+        const int num_high = _mm_popcnt_u32(mask);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + left), sorted);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + right - W), sorted);
+        left += W - num_high;
+        right -= num_high;
+    }
+
+    // Distribute the unread elements and the buffered vectors
+    int tmp[3 * W];
+    const int rest = r - l;
+    for (int m = 0; m < rest; m++) {
+        tmp[m] = a[l + m];
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(tmp + rest), first);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(tmp + rest + W), last);
+
+    return distribute(a, left, right, tmp, rest + 2 * W, pivot);
+}
+
+// AVX-512 kernel: 16 elements per step, written at both ends with compress-stores
+__attribute__((target("avx512f,popcnt"))) static int partition_le_avx512(int *a, const int n, const int pivot) {
+    constexpr int W = 16;
+    if (n < 2 * W) {
+        return partition_le_scalar(a, n, pivot);
+    }
+
+    const __m512i pivot_vec = _mm512_set1_epi32(pivot);
+
+    // Buffer the first and the last vector to make room for the stores at both ends
+    const __m512i first = _mm512_loadu_si512(a);
+    const __m512i last = _mm512_loadu_si512(a + n - W);
+
+    int l = W, r = n - W; // Elements in [l, r) have not been read yet
+    int left = 0, right = n; // Elements in [0, left) are <= pivot, elements in [right, n) are > pivot
+
+    while (r - l >= W) {
+        // Read from the side with less free space, so that the stores never reach unread elements
+        __m512i v;
+        if (l - left <= right - r) {
+            v = _mm512_loadu_si512(a + l);
+            l += W;
+        } else {
+            r -= W;
+            v = _mm512_loadu_si512(a + r);
+        }
+
+        const __mmask16 low = _mm512_cmple_epi32_mask(v, pivot_vec);
+        const int num_low = _mm_popcnt_u32(low);
+
+        _mm512_mask_compressstoreu_epi32(a + left, low, v);
+        _mm512_mask_compressstoreu_epi32(a + right - (W - num_low), static_cast<__mmask16>(~low), v);
+        left += num_low;
+        right -= W - num_low;
+    }
+
+    // Distribute the unread elements and the buffered vectors
+    int tmp[3 * W];
+    const int rest = r - l;
+    for (int m = 0; m < rest; m++) {
+        tmp[m] = a[l + m];
+    }
+    _mm512_storeu_si512(tmp + rest, first);
+    _mm512_storeu_si512(tmp + rest + W, last);
+
+    return distribute(a, left, right, tmp, rest + 2 * W, pivot);
+}
+
+#endif
+
+// Select the widest kernel supported by the CPU
+static SimdKernelFunction select_kernel() {
+#ifdef SIMD_PARTITION_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return partition_le_avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return partition_le_avx2;
+    }
+#endif
+    return partition_le_scalar;
+}
+
+// Kernel selected on first use
+static SimdKernelFunction get_kernel() {
+    static const SimdKernelFunction kernel = select_kernel();
+    return kernel;
+}
+
+// Name of the kernel selected for this CPU
+const char *simd_partition_kernel_name() {
+#ifdef SIMD_PARTITION_X86
+    if (get_kernel() == partition_le_avx512) {
+        return "avx512";
+    }
+    if (get_kernel() == partition_le_avx2) {
+        return "avx2";
+    }
+#endif
+    return "scalar";
+}
+
+// Partition the elements less than or equal to the pivot to the front of a[0:n]
+int simd_partition_le(int *a, const int n, const int pivot) {
+    return get_kernel()(a, n, pivot);
+}
+
+// Vectorized partition function to rearrange the elements around the pivot
+int simd_partition(int *a, const int i, const int j) {
+    const int pivot = a[j - 1]; // Choose the last element as the pivot
+
+    // Partition the elements before the pivot, then move the pivot between the two partitions
+    const int k = i + simd_partition_le(a + i, j - 1 - i, pivot);
+    swap(a, k, j - 1);
+    return k;
+}
+
+// Vectorized 3-way partition function
+void simd_partition_3way(int *a, const int i, const int j, int *k, int *l) {
+    const int pivot = a[j - 1]; // Choose the last element as the pivot
+
+    // First pass: elements <= pivot before the elements > pivot
+    const int end_equal = i + simd_partition_le(a + i, j - i, pivot);
+
+    // Second pass on the first part: elements < pivot (that is, <= pivot - 1) before the elements == pivot
+    int start_equal = i;
+    if (pivot > INT_MIN) {
+        start_equal = i + simd_partition_le(a + i, end_equal - i, pivot - 1);
+    }
+
+    *k = start_equal; // Set `k` to the start of the == pivot region
+    *l = end_equal; // Set `l` to the end of the == pivot region
+}
@@ -0,0 +1,138 @@
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "task_pool.h"
+
+// Pool and index of the worker running on the current thread.
+// Threads that do not belong to a pool act as worker 0.
+static thread_local const TaskPool *current_pool = nullptr;
+static thread_local int current_index = 0;
+
+TaskPool::TaskPool(const int num_threads) {
+    const int n = num_threads < 1 ? 1 : num_threads;
+
+    // Create one queue for each thread, including the waiting thread
+    for (int i = 0; i < n; i++) {
+        queues.push_back(std::make_unique<WorkerQueue_t>());
+    }
+
+    // Start the worker threads
+    for (int i = 1; i < n; i++) {
+        threads.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    sleep_cv.notify_all();
+
+    for (auto &thread: threads) {
+        thread.join();
+    }
+}
+
+int TaskPool::size() const {
+    return static_cast<int>(queues.size());
+}
+
+// Queue a task at the back of the queue of the calling worker
+void TaskPool::spawn(TaskGroup &group, std::function<void()> task) {
+    const int self = current_pool == this ? current_index : 0;
+
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(queues[self]->mutex);
+        queues[self]->tasks.emplace_back([task = std::move(task), &group] {
+            task();
+            group.pending.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    queued.fetch_add(1, std::memory_order_release);
+
+    // Wake up a sleeping worker, if any
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    sleep_cv.notify_one();
+}
+
+// Help executing tasks until the group has finished
+void TaskPool::wait(TaskGroup &group) {
+    const int self = current_pool == this ? current_index : 0;
+
+    while (group.pending.load(std::memory_order_acquire) > 0) {
+        if (!run_one(self)) {
+            // The remaining tasks are running on other workers
+            std::this_thread::yield();
+        }
+    }
+}
+
+// Execute a task for each index and wait for all of them
+void TaskPool::parallel_for(const int num_tasks, const std::function<void(int)> &body) {
+    TaskGroup group;
+    for (int t = 0; t < num_tasks; t++) {
+        spawn(group, [&body, t] { body(t); });
+    }
+    wait(group);
+}
+
+// Execute one task, from the own queue if possible, otherwise stolen from another worker
+bool TaskPool::run_one(const int self) {
+    std::function<void()> task;
+    const int n = size();
+
+    // Take the newest task of the own queue
+    {
+        std::lock_guard<std::mutex> lock(queues[self]->mutex);
+        if (!queues[self]->tasks.empty()) {
+            task = std::move(queues[self]->tasks.back());
+            queues[self]->tasks.pop_back();
+        }
+    }
+
+    // Steal the oldest task of another queue
+    for (int k = 1; !task && k < n; k++) {
+        WorkerQueue_t &victim = *queues[(self + k) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+
+    if (!task) {
+        return false;
+    }
+
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    task();
+    return true;
+}
+
+// Execute tasks until the pool is destroyed, sleeping while there is nothing to do
+void TaskPool::worker_loop(const int self) {
+    current_pool = this;
+    current_index = self;
+
+    while (!stopping.load(std::memory_order_acquire)) {
+        if (run_one(self)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleep_cv.wait(lock, [this] { return stopping.load() || queued.load() > 0; });
+    }
+}
+
+int default_thread_count() {
+    const unsigned int n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : static_cast<int>(n);
+}
@@ -0,0 +1,106 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Counter of the tasks spawned by a fork-join computation that have not finished yet
+ */
+struct TaskGroup_t {
+    std::atomic<int> pending{0}; // Number of tasks still queued or running
+} typedef TaskGroup;
+
+/**
+ * @brief Work-stealing pool of worker threads
+ *
+ * Every worker owns a double-ended queue of tasks. A worker pushes and pops tasks at the back of its own queue
+ * (so the most recently split, cache-hot subproblem runs first) and, when its queue is empty, steals from the
+ * front of the queue of another worker (so it takes the oldest, and usually largest, subproblem).
+ * The thread that calls wait() takes part in the computation as worker 0.
+ */
+class TaskPool {
+public:
+    /**
+     * @brief Create the pool and start num_threads - 1 worker threads
+     * @param num_threads The total number of threads, including the thread that calls wait()
+     */
+    explicit TaskPool(int num_threads);
+
+    /**
+     * @brief Stop and join all the worker threads
+     */
+    ~TaskPool();
+
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+
+    /**
+     * @brief Get the number of threads of the pool
+     * @return the number of threads, including the thread that calls wait()
+     */
+    int size() const;
+
+    /**
+     * @brief Queue a task on the queue of the calling worker
+     * @param group The group the task belongs to
+     * @param task The task to execute
+     */
+    void spawn(TaskGroup &group, std::function<void()> task);
+
+    /**
+     * @brief Execute queued tasks until every task of the group has finished
+     * @param group The group to wait for
+     */
+    void wait(TaskGroup &group);
+
+    /**
+     * @brief Execute body(0), ..., body(num_tasks - 1) on the pool and wait for all of them
+     * @param num_tasks The number of tasks
+     * @param body The function executed by each task, called with the index of the task
+     */
+    void parallel_for(int num_tasks, const std::function<void(int)> &body);
+
+private:
+    /**
+     * @brief Queue of tasks owned by a single worker
+     */
+    struct WorkerQueue_t {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    /**
+     * @brief Pop a task from the own queue or steal one from another worker and execute it
+     * @param self The index of the calling worker
+     * @return true if a task has been executed, false if every queue was empty
+     */
+    bool run_one(int self);
+
+    /**
+     * @brief Main loop of a worker thread
+     * @param self The index of the worker
+     */
+    void worker_loop(int self);
+
+    std::vector<std::unique_ptr<WorkerQueue_t>> queues; // One queue per thread, index 0 is the waiting thread
+    std::vector<std::thread> threads; // Worker threads 1..n-1
+    std::atomic<int> queued{0}; // Number of tasks in all the queues
+    std::atomic<bool> stopping{false}; // Set when the pool is being destroyed
+    std::mutex sleep_mutex; // Protects the sleeping workers
+    std::condition_variable sleep_cv; // Wakes up the sleeping workers when a task is queued
+};
+
+/**
+ * @brief Get the default number of threads for the parallel algorithms
+ * @return the number of hardware threads, or 1 if it cannot be determined
+ */
+int default_thread_count();
+
+#endif
@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <random>
@@ -9,13 +11,52 @@
 #include <string>
 #include <vector>
 
+#include "sort_base.h"
 #include "utils.h"
 
+// Function to perform insertion sort on a subarray.
+void insertion_sort(int arr[], const int left, const int right) {
+    sort_lib::insertion_sort(arr, left, right, std::less<>());
+}
+
+// Random number generator of the input data, seeded randomly unless set_input_seed is called
+static std::mt19937 input_generator{std::random_device{}()};
+static bool input_seeded = false; // Whether set_input_seed was called
+static unsigned int input_seed = 0; // Seed given to set_input_seed
+
+// Function to seed the generator of the input data
+void set_input_seed(const unsigned int seed) {
+    input_generator.seed(seed);
+    input_seeded = true;
+    input_seed = seed;
+}
+
+// Function to get the generator of the input data
+std::mt19937 &get_input_generator() {
+    return input_generator;
+}
+
+// Function to seed the generator of the input data for a sample point of a sweep
+static void seed_sample_point(const int index) {
+    if (input_seeded) {
+        std::seed_seq sequence{input_seed, static_cast<unsigned int>(index)};
+        input_generator.seed(sequence);
+    }
+}
+
+// Move the element at index k down the heap rooted at index i
+void sift_down(int *a, const int i, const int k, const int n) {
+    sort_lib::sift_down(a, i, k, n, std::less<>());
+}
+
+// HeapSort function to sort the subarray a[i:j] (j exclusive)
+void heap_sort(int *a, const int i, const int j) {
+    sort_lib::heap_sort(a, i, j, std::less<>());
+}
+
 // Function to generate an array of random integers
 void generate_input_data(int out[], const int n, const int min, const int max) {
-    // Initialize random number generator
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 &gen = input_generator;
     std::uniform_int_distribution<> dis(min, max);
 
     // Create and fill an array with random integers
@@ -24,10 +65,67 @@ void generate_input_data(int out[], const int n, const int min, const int max) {
     }
 
     // Put in a random position the maximum value
-    const int max_pos = dis(gen) % n;
+    std::uniform_int_distribution<> pos(0, n - 1);
+    const int max_pos = pos(gen);
     out[max_pos] = max;
 }
 
+// Function to check if the name of an input order is known
+bool is_valid_input_order(const std::string &order) {
+    return order == "random" || order == "sorted" || order == "reversed" || order == "organ_pipe" ||
+           order == "nearly_sorted" || order == "shuffled_runs";
+}
+
+// Function to rearrange the input data into a given order
+void arrange_input_data(int out[], const int n, const std::string &order) {
+    if (!is_valid_input_order(order)) {
+        throw std::invalid_argument("Unknown input order: " + order);
+    }
+
+    if (order == "random") {
+        return;
+    }
+
+    std::sort(out, out + n);
+
+    if (order == "reversed") {
+        std::reverse(out, out + n);
+    } else if (order == "organ_pipe") {
+        // Even positions ascending in the first half, odd positions descending in the second half
+        std::vector<int> sorted(out, out + n);
+        int left = 0, right = n - 1;
+        for (int i = 0; i < n; i++) {
+            if (i % 2 == 0) {
+                out[left++] = sorted[i];
+            } else {
+                out[right--] = sorted[i];
+            }
+        }
+    } else if (order == "nearly_sorted" && n > 1) {
+        std::uniform_int_distribution<> pos(0, n - 1);
+        for (int s = 0; s < n / 100 + 1; s++) {
+            std::swap(out[pos(input_generator)], out[pos(input_generator)]);
+        }
+    } else if (order == "shuffled_runs") {
+        // Cut the sorted array into runs of consecutive values and concatenate them in random order
+        constexpr int num_runs = 32;
+        std::vector<int> sorted(out, out + n);
+        std::vector<int> runs(num_runs);
+        for (int r = 0; r < num_runs; r++) {
+            runs[r] = r;
+        }
+        std::shuffle(runs.begin(), runs.end(), input_generator);
+        int k = 0;
+        for (const int r: runs) {
+            const long long begin = static_cast<long long>(n) * r / num_runs;
+            const long long end = static_cast<long long>(n) * (r + 1) / num_runs;
+            for (long long m = begin; m < end; m++) {
+                out[k++] = sorted[m];
+            }
+        }
+    }
+}
+
 // Function to check if the array is sorted
 void check_result(const int n, const int data[]) {
     for (int i = 0; i < n - 1; i++) {
@@ -107,6 +205,253 @@ std::string generate_filename(const std::string &test_type, const bool linear_sc
     return ss.str();
 }
 
+// Hardware performance counters
+#if defined(__linux__)
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Names of the counters, also the columns of the CSV files
+static const char *const PERF_COUNTER_NAMES[NUM_PERF_COUNTERS] = {
+        "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses", "dtlb_misses",
+};
+
+static bool perf_enabled = false; // Whether enable_perf_counters succeeded
+static int perf_fds[NUM_PERF_COUNTERS]; // File descriptors of the counters, -1 if unavailable
+static double perf_values[NUM_PERF_COUNTERS]; // Events per execution of the last measurement, -1 if not counted
+static bool perf_pending = false; // Whether the last measurement has not been added to a sample point yet
+
+#if defined(__linux__)
+// Open a counter of the calling thread in user space, in the group of the leader or as the leader if it is -1
+static int open_perf_counter(const uint32_t type, const uint64_t config, const int leader) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = leader == -1; // The leader starts and stops the whole group
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // The kernel multiplexes the group if the counters are shared, the times allow to scale the values
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+}
+
+// Get the configuration of a read miss counter of a cache
+static uint64_t cache_miss_config(const uint64_t cache) {
+    return cache | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+}
+#endif
+
+// Function to open the hardware performance counters
+bool enable_perf_counters() {
+#if defined(__linux__)
+    const uint32_t types[NUM_PERF_COUNTERS] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+            PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE,
+    };
+    const uint64_t configs[NUM_PERF_COUNTERS] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_BRANCH_MISSES,
+            cache_miss_config(PERF_COUNT_HW_CACHE_L1D),
+            cache_miss_config(PERF_COUNT_HW_CACHE_LL),
+            cache_miss_config(PERF_COUNT_HW_CACHE_DTLB),
+    };
+
+    // The cycles lead the group, the other counters are optional
+    perf_fds[CYCLES_COUNTER] = open_perf_counter(types[CYCLES_COUNTER], configs[CYCLES_COUNTER], -1);
+    if (perf_fds[CYCLES_COUNTER] == -1) {
+        std::cerr << "Hardware performance counters unavailable (" << strerror(errno)
+                  << "), only the time is measured" << std::endl;
+        return false;
+    }
+    for (int c = CYCLES_COUNTER + 1; c < NUM_PERF_COUNTERS; c++) {
+        perf_fds[c] = open_perf_counter(types[c], configs[c], perf_fds[CYCLES_COUNTER]);
+        if (perf_fds[c] == -1) {
+            std::cerr << "Hardware performance counter unavailable: " << PERF_COUNTER_NAMES[c] << std::endl;
+        }
+    }
+
+    perf_enabled = true;
+    return true;
+#else
+    std::cerr << "Hardware performance counters are only supported on Linux, only the time is measured" << std::endl;
+    return false;
+#endif
+}
+
+// Function to open the hardware performance counters again in a new process, which does not count the events of its
+// parent's counters
+static void reopen_perf_counters() {
+#if defined(__linux__)
+    if (!perf_enabled) {
+        return;
+    }
+    for (int &fd: perf_fds) {
+        if (fd != -1) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    perf_enabled = false;
+    enable_perf_counters();
+#endif
+}
+
+// Function to check if the hardware performance counters are enabled
+bool perf_counters_enabled() {
+    return perf_enabled;
+}
+
+// Function to start the hardware performance counters
+void start_perf_counters() {
+#if defined(__linux__)
+    if (perf_enabled) {
+        ioctl(perf_fds[CYCLES_COUNTER], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(perf_fds[CYCLES_COUNTER], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+// Function to pause the hardware performance counters
+void pause_perf_counters() {
+#if defined(__linux__)
+    if (perf_enabled) {
+        ioctl(perf_fds[CYCLES_COUNTER], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+// Function to resume the hardware performance counters
+void resume_perf_counters() {
+#if defined(__linux__)
+    if (perf_enabled) {
+        ioctl(perf_fds[CYCLES_COUNTER], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+// Function to stop the hardware performance counters and read the events per execution
+void stop_perf_counters(const int iterations) {
+#if defined(__linux__)
+    if (!perf_enabled) {
+        return;
+    }
+    ioctl(perf_fds[CYCLES_COUNTER], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+        perf_values[c] = -1;
+        uint64_t value[3]; // Count, time enabled and time running
+        if (perf_fds[c] == -1 || read(perf_fds[c], value, sizeof(value)) != sizeof(value) || value[2] == 0) {
+            continue;
+        }
+        // Scale the count to the whole time if the group was multiplexed
+        const double count = static_cast<double>(value[0]) * static_cast<double>(value[1]) / value[2];
+        perf_values[c] = count / iterations;
+    }
+    perf_pending = true;
+#endif
+}
+
+// Function to add the last measurement of the hardware performance counters to a sample point
+void add_perf_counters(RunResult *run) {
+    if (!perf_pending) {
+        return;
+    }
+    for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+        // A counter missing from one run is missing from the sample point
+        if (perf_values[c] < 0 || run->counters[c] < 0) {
+            run->counters[c] = -1;
+        } else {
+            run->counters[c] += perf_values[c] / NUM_RUNS;
+        }
+    }
+    perf_pending = false;
+}
+
+// What the timed loops of the benchmarks measure
+static TimingMode timing_mode = TOTAL_TIMING;
+static double last_copy_time = 0; // Mean preparation time of the last measurement
+static bool copy_time_pending = false; // Whether the last preparation time has not been added to a sample point yet
+
+// Function to select the timing mode
+void set_timing_mode(const TimingMode mode) {
+    timing_mode = mode;
+}
+
+// Function to get the timing mode
+TimingMode get_timing_mode() {
+    return timing_mode;
+}
+
+// Function to get the timing mode from its option
+bool parse_timing_mode(const std::string &name, TimingMode *mode) {
+    if (name == "total") {
+        *mode = TOTAL_TIMING;
+        return true;
+    }
+    if (name == "sort") {
+        *mode = SORT_TIMING;
+        return true;
+    }
+    return false;
+}
+
+// Function to get the number of inputs prepared at once
+int copy_ring_size(const long long bytes) {
+    if (timing_mode == TOTAL_TIMING || bytes <= 0) {
+        return 1;
+    }
+    return static_cast<int>(std::max(1LL, std::min(static_cast<long long>(COPY_RING_SIZE), COPY_RING_BYTES / bytes)));
+}
+
+// Function to measure the overhead of the clock reads around a timed execution
+double get_timer_overhead() {
+    static double overhead = -1;
+    if (overhead >= 0) {
+        return overhead;
+    }
+
+    // Keep the lowest mean of several rounds, the others may have been interrupted
+    constexpr int rounds = 16, iterations = 1000;
+    overhead = 1e18;
+    for (int round = 0; round < rounds; round++) {
+        long long total = 0;
+        for (int i = 0; i < iterations; i++) {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            const time_point_t start = std::chrono::steady_clock::now();
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            const time_point_t end = std::chrono::steady_clock::now();
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            total += std::chrono::duration_cast<time_unit_t>(end - start).count();
+        }
+        overhead = std::min(overhead, static_cast<double>(total) / iterations);
+    }
+    return overhead;
+}
+
+// Function to keep the preparation time of the last measurement
+void set_copy_time(const double time) {
+    last_copy_time = time;
+    copy_time_pending = true;
+}
+
+// Function to add the preparation time of the last measurement to a sample point
+void add_copy_time(RunResult *run) {
+    if (!copy_time_pending) {
+        return;
+    }
+    run->copy_time += last_copy_time / NUM_RUNS;
+    copy_time_pending = false;
+}
+
 // Function to write benchmark results to a CSV file
 void write_results_to_csv(const std::string &filename, const std::vector<RunResult> &runs) {
     std::ofstream file(filename);
@@ -120,15 +465,35 @@ void write_results_to_csv(const std::string &filename, const std::vector<RunResu
     for (int r = 0; r < NUM_RUNS; r++) {
         file << ",time_" << r;
     }
+    if (timing_mode == SORT_TIMING) {
+        file << ",copy_time";
+    }
+    if (perf_enabled) {
+        for (const char *name: PERF_COUNTER_NAMES) {
+            file << "," << name;
+        }
+    }
     file << std::endl;
+    file << std::fixed << std::setprecision(1);
 
     // Write data rows
-    for (const auto &[min, max, length, time]: runs) {
+    for (const auto &[min, max, length, time, counters, copy_time]: runs) {
         file << length << "," << min << "," << max;
 
         for (int r = 0; r < NUM_RUNS; r++) {
             file << "," << time[r];
         }
+        if (timing_mode == SORT_TIMING) {
+            file << "," << copy_time;
+        }
+        if (perf_enabled) {
+            for (const double count: counters) {
+                file << ",";
+                if (count >= 0) {
+                    file << count;
+                }
+            }
+        }
 
         file << std::endl;
     }
@@ -146,10 +511,27 @@ void write_results_to_csv(const std::string &filename, const std::vector<RunResu
 #include <sys/sysctl.h>
 #include <sys/types.h>
 #endif
+
+#if defined(__linux__)
+static cpu_set_t allowed_cpus; // Cores the process may run on, before set_cpu_affinity pins it
+static bool allowed_cpus_known = false; // Whether allowed_cpus was read
+
+// Read the cores the process may run on, once
+static void read_allowed_cpus() {
+    if (!allowed_cpus_known) {
+        CPU_ZERO(&allowed_cpus);
+        allowed_cpus_known = sched_getaffinity(0, sizeof(allowed_cpus), &allowed_cpus) == 0;
+    }
+}
+#endif
+
 // Set CPU affinity to the first core
 // and increase the priority of the process to the maximum
 void set_cpu_affinity() {
 #if defined(__linux__)
+    // Keep the cores the process may run on, to check the cores of the sweep workers
+    read_allowed_cpus();
+
     // Set CPU affinity to the first core
     cpu_set_t mask;
     CPU_ZERO(&mask);
@@ -157,7 +539,20 @@ void set_cpu_affinity() {
     if (sched_setaffinity(0, sizeof(mask), &mask) == -1) {
         std::cerr << "Failed to set CPU affinity" << std::endl;
     }
+#elif defined(_WIN32)
+    // Set CPU affinity to the first core
+    DWORD_PTR mask = 1;
+    if (!SetProcessAffinityMask(GetCurrentProcess(), mask)) {
+        std::cerr << "Failed to set CPU affinity" << std::endl;
+    }
+#endif
+
+    set_process_priority();
+}
 
+// Increase the priority of the process to the maximum
+void set_process_priority() {
+#if defined(__linux__)
     // Set nice value to -20 to increase the priority of the process to the
     // maximum
     if (nice(-20) == -1) {
@@ -169,12 +564,6 @@ void set_cpu_affinity() {
     }
 
 #elif defined(_WIN32)
-    // Set CPU affinity to the first core
-    DWORD_PTR mask = 1;
-    if (!SetProcessAffinityMask(GetCurrentProcess(), mask)) {
-        std::cerr << "Failed to set CPU affinity" << std::endl;
-    }
-
     // Increase the priority of the process to the maximum
     if (!SetPriorityClass(GetCurrentProcess(), REALTIME_PRIORITY_CLASS)) {
         std::cerr << "Failed to set priority class" << std::endl;
@@ -202,3 +591,267 @@ std::vector<int> read_input_data() {
 
     return data;
 }
+
+// Function to get the positional command-line arguments
+std::vector<std::string> get_positional_arguments(const int argc, char *argv[]) {
+    std::vector<std::string> args;
+    for (int i = 0; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            args.push_back(arg);
+        }
+    }
+
+    return args;
+}
+
+// Function to get the value of a --name=value command-line option
+std::string get_option(const int argc, char *argv[], const std::string &name, const std::string &default_value) {
+    const std::string prefix = "--" + name + "=";
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg.rfind(prefix, 0) == 0) {
+            return arg.substr(prefix.size());
+        }
+    }
+
+    return default_value;
+}
+
+// Function to check if a --name command-line flag is present
+bool has_flag(const int argc, char *argv[], const std::string &name) {
+    const std::string flag = "--" + name;
+    for (int i = 1; i < argc; i++) {
+        if (flag == argv[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Function to parse a list of cores such as "2,3,6-8"
+bool parse_core_list(const std::string &text, std::vector<int> *cores) {
+    cores->clear();
+    if (text.empty()) {
+        return true;
+    }
+
+    std::istringstream iss(text);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        // Each item is a core or an inclusive range of cores
+        const size_t dash = item.find('-');
+        int first, last;
+        try {
+            size_t end;
+            first = std::stoi(item.substr(0, dash), &end);
+            if (end != item.substr(0, dash).size()) {
+                return false;
+            }
+            last = first;
+            if (dash != std::string::npos) {
+                last = std::stoi(item.substr(dash + 1), &end);
+                if (end != item.size() - dash - 1) {
+                    return false;
+                }
+            }
+        } catch (const std::exception &) {
+            return false;
+        }
+        if (first < 0 || last < first) {
+            return false;
+        }
+        for (int core = first; core <= last; core++) {
+            if (std::find(cores->begin(), cores->end(), core) != cores->end()) {
+                return false;
+            }
+            cores->push_back(core);
+        }
+    }
+
+#if defined(__linux__)
+    // Check the cores before any worker starts, a worker only fails to pin itself after the others have finished
+    read_allowed_cpus();
+    for (const int core: *cores) {
+        if (core >= CPU_SETSIZE || (allowed_cpus_known && !CPU_ISSET(core, &allowed_cpus))) {
+            std::cerr << "Core " << core << " is not available to this process" << std::endl;
+            return false;
+        }
+    }
+#endif
+
+    return !cores->empty();
+}
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/wait.h>
+
+// Write a buffer to a pipe, return false if the reader is gone
+static bool write_all(const int fd, const char *data, size_t bytes) {
+    while (bytes > 0) {
+        const ssize_t written = write(fd, data, bytes);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        bytes -= written;
+    }
+    return true;
+}
+
+// Read a buffer from a pipe, return false at the end of the pipe
+static bool read_all(const int fd, char *data, size_t bytes) {
+    while (bytes > 0) {
+        const ssize_t count = read(fd, data, bytes);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        data += count;
+        bytes -= count;
+    }
+    return true;
+}
+
+// Measure the sample points of a worker pinned to a core and send the results to the parent, never returns
+[[noreturn]] static void run_sweep_worker(const int worker, const std::vector<int> &cores, const int num_points,
+                                          const size_t result_size,
+                                          const std::function<void(int, void *)> &measure, const int fd) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cores[worker], &mask);
+    if (sched_setaffinity(0, sizeof(mask), &mask) == -1) {
+        std::cerr << "Failed to set CPU affinity to core " << cores[worker] << ": " << strerror(errno) << std::endl;
+        _exit(1);
+    }
+
+    // The workers must not count the events of the parent, nor generate the same input data
+    reopen_perf_counters();
+    if (!input_seeded) {
+        input_generator.seed(std::random_device{}());
+    }
+
+    // Every message is the index of a sample point followed by its result
+    std::vector<char> message(sizeof(int) + result_size);
+    for (int i = worker; i < num_points; i += static_cast<int>(cores.size())) {
+        seed_sample_point(i);
+        memcpy(message.data(), &i, sizeof(int));
+        measure(i, message.data() + sizeof(int));
+        if (!write_all(fd, message.data(), message.size())) {
+            _exit(1);
+        }
+    }
+
+    // Skip the destructors of the parent's objects, e.g. the threads of a pool that do not exist in this process
+    std::cout.flush();
+    _exit(0);
+}
+#endif
+
+// Function to measure the sample points of a sweep, sharded across pinned worker processes
+bool run_sweep_points(const int num_points, const std::vector<int> &cores, const size_t result_size,
+                      const std::function<void(int, void *)> &measure, void *results) {
+    auto *result_bytes = static_cast<char *>(results);
+
+#if defined(__linux__)
+    if (!cores.empty()) {
+        // Do not let the workers print the output buffered so far again
+        std::cout.flush();
+        std::cerr.flush();
+
+        std::vector<pid_t> workers;
+        std::vector<pollfd> pipes;
+        for (int w = 0; w < static_cast<int>(cores.size()); w++) {
+            int fds[2];
+            if (pipe(fds) == -1) {
+                std::cerr << "Failed to create a pipe: " << strerror(errno) << std::endl;
+                break;
+            }
+            const pid_t pid = fork();
+            if (pid == 0) {
+                close(fds[0]);
+                for (const pollfd &other: pipes) {
+                    close(other.fd);
+                }
+                run_sweep_worker(w, cores, num_points, result_size, measure, fds[1]);
+            }
+            close(fds[1]);
+            if (pid == -1) {
+                std::cerr << "Failed to start a worker: " << strerror(errno) << std::endl;
+                close(fds[0]);
+                break;
+            }
+            workers.push_back(pid);
+            pipes.push_back(pollfd{fds[0], POLLIN, 0});
+        }
+
+        // Collect the results as the workers send them, until every pipe is closed
+        int received = 0;
+        std::vector<char> message(sizeof(int) + result_size);
+        while (!pipes.empty()) {
+            if (poll(pipes.data(), pipes.size(), -1) == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::cerr << "Failed to wait for the workers: " << strerror(errno) << std::endl;
+                break;
+            }
+            for (size_t p = 0; p < pipes.size();) {
+                if (pipes[p].revents == 0) {
+                    p++;
+                    continue;
+                }
+                // A worker that exits closes its pipe, possibly in the middle of a message if it failed
+                int index = -1;
+                const bool complete = read_all(pipes[p].fd, message.data(), message.size());
+                if (complete) {
+                    memcpy(&index, message.data(), sizeof(int));
+                }
+                if (index >= 0 && index < num_points) {
+                    memcpy(result_bytes + index * result_size, message.data() + sizeof(int), result_size);
+                    received++;
+                    p++;
+                } else {
+                    close(pipes[p].fd);
+                    pipes.erase(pipes.begin() + p);
+                }
+            }
+        }
+        for (const pollfd &other: pipes) {
+            close(other.fd);
+        }
+
+        bool succeeded = received == num_points;
+        for (const pid_t pid: workers) {
+            int status;
+            if (waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                succeeded = false;
+            }
+        }
+        if (!succeeded) {
+            std::cerr << "A worker of the sweep failed, " << received << " of " << num_points
+                      << " sample points were measured" << std::endl;
+        }
+        return succeeded;
+    }
+#else
+    if (!cores.empty()) {
+        std::cerr << "Sharding the sweep across cores is only supported on Linux, running it on one core"
+                  << std::endl;
+    }
+#endif
+
+    // Measure the sample points in order on this process
+    for (int i = 0; i < num_points; i++) {
+        seed_sample_point(i);
+        measure(i, result_bytes + i * result_size);
+    }
+    return true;
+}
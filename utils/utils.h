@@ -1,18 +1,50 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <random>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 // Number of runs to average the execution time
 constexpr int NUM_RUNS = 48;
 constexpr int NUM_SAMPLES = 200;
 
+// Maximum number of inputs prepared at once by the sort timing mode.
+constexpr int COPY_RING_SIZE = 8;
+// Maximum size of the inputs prepared at once by the sort timing mode, in bytes.
+constexpr long long COPY_RING_BYTES = 64LL << 20;
+
 // Standard types
 typedef std::chrono::nanoseconds time_unit_t;
 typedef std::chrono::duration<long long, time_unit_t> duration_t;
 typedef std::chrono::time_point<std::chrono::steady_clock> time_point_t;
 
+/**
+ * @brief Hardware events counted by the performance counters
+ */
+enum PerfCounter_t {
+    CYCLES_COUNTER, // CPU cycles
+    INSTRUCTIONS_COUNTER, // Instructions retired
+    BRANCH_MISSES_COUNTER, // Mispredicted branches
+    L1D_MISSES_COUNTER, // Read misses of the L1 data cache
+    LLC_MISSES_COUNTER, // Read misses of the last level cache
+    DTLB_MISSES_COUNTER, // Read misses of the data TLB
+    NUM_PERF_COUNTERS, // Number of counters
+} typedef PerfCounter;
+
+/**
+ * @brief What the timed loops of the benchmarks measure
+ */
+enum TimingMode_t {
+    TOTAL_TIMING, // The preparation of the input (the copy of the data) and the algorithm, as a whole
+    SORT_TIMING, // Every execution of the algorithm alone; the preparation of the inputs is measured apart
+} typedef TimingMode;
+
 /**
  * @brief Structure to store benchmark results
  */
@@ -21,6 +53,8 @@ struct RunResult_t {
     int max; // Maximum value of the array
     int length; // Length of the array
     long long time[NUM_RUNS]; // Execution time of the algorithm
+    double counters[NUM_PERF_COUNTERS]; // Mean number of events per execution over the runs, -1 if unavailable
+    double copy_time; // Mean time of the preparation of an input over the runs in nanoseconds, with SORT_TIMING
 } typedef RunResult;
 
 /**
@@ -35,6 +69,49 @@ inline void swap(int *a, const int k, const int l) {
     a[l] = temp;
 }
 
+/**
+ * @brief Sort the array using the insertion sort algorithm.
+ * @param arr The array to sort
+ * @param left The left index of the array
+ * @param right The right index of the array (inclusive)
+ */
+void insertion_sort(int arr[], int left, int right);
+
+/**
+ * @brief Move the element at index k of the heap down until both its children are smaller
+ * @param a The array of integers
+ * @param i The index of the root of the heap
+ * @param k The index of the element to move down
+ * @param n The number of elements of the heap
+ */
+void sift_down(int *a, int i, int k, int n);
+
+/**
+ * HeapSort function to sort the subarray a[i:j] (j exclusive)
+ * @param a The array of integers
+ * @param i The index of the first element
+ * @param j The index of the last element
+ */
+void heap_sort(int *a, int i, int j);
+
+/**
+ * @brief Seed the random number generator of the input data
+ *
+ * By default the generator is seeded randomly. With the same seed, the same sequence of calls to
+ * generate_input_data and arrange_input_data produces the same arrays, in any executable. run_sweep seeds the
+ * generator again for every sample point from the seed and the index of the point, so that a sample point gets the
+ * same arrays whichever worker measures it.
+ *
+ * @param seed the seed
+ */
+void set_input_seed(unsigned int seed);
+
+/**
+ * @brief Get the random number generator of the input data, seeded by set_input_seed
+ * @return the generator shared by generate_input_data and arrange_input_data
+ */
+std::mt19937 &get_input_generator();
+
 /**
  * @brief Generate an array of random integers
  * @param out the output array
@@ -45,6 +122,24 @@ inline void swap(int *a, const int k, const int l) {
  */
 void generate_input_data(int out[], int n, int min, int max);
 
+/**
+ * @brief Check if the name of an input order is known
+ * @param order the name of the order
+ * @return true if arrange_input_data accepts the order
+ */
+bool is_valid_input_order(const std::string &order);
+
+/**
+ * @brief Rearrange the generated input data into a given order
+ * @param out the array to rearrange
+ * @param n the size of the array
+ * @param order "random" (unchanged), "sorted", "reversed", "organ_pipe" (ascending then descending)
+ * "nearly_sorted" (sorted, then 1% of the elements swapped at random) or "shuffled_runs" (sorted, then cut into
+ * 32 runs that are concatenated in random order)
+ * @throws std::invalid_argument if the order is unknown
+ */
+void arrange_input_data(int out[], int n, const std::string &order);
+
 /**
  * @brief Check if the array is sorted
  * @param n the size of the array
@@ -89,21 +184,282 @@ std::string generate_filename(const std::string &test_type, bool linear_scaling,
 /**
  * @brief Write benchmark results to a CSV file
  *
+ * With SORT_TIMING, a copy_time column follows the times. If the hardware performance counters are enabled, a column
+ * per counter follows; the cells of the counters that are not available are empty.
+ *
  * @param filename the name of the file to write to
  * @param runs the vector of benchmark runs
  */
 void write_results_to_csv(const std::string &filename, const std::vector<RunResult> &runs);
 
+/**
+ * @brief Open the hardware performance counters of the calling thread
+ *
+ * The counters are grouped, so that they count the same instructions. Counters that the CPU or the kernel does not
+ * support are left out; if none is available, a warning is printed and the benchmarks only measure the time.
+ * The counters are only available on Linux, with perf_event_paranoid at most 2. They do not count the events of
+ * other threads, so the benchmarks reject them together with a pool of several threads.
+ *
+ * @return true if the counters are enabled
+ */
+bool enable_perf_counters();
+
+/**
+ * @brief Check if the hardware performance counters are enabled
+ * @return true if enable_perf_counters succeeded
+ */
+bool perf_counters_enabled();
+
+/**
+ * @brief Reset and start the hardware performance counters, if they are enabled
+ */
+void start_perf_counters();
+
+/**
+ * @brief Stop the hardware performance counters without reading them, if they are enabled
+ */
+void pause_perf_counters();
+
+/**
+ * @brief Start the hardware performance counters again without resetting them, if they are enabled
+ */
+void resume_perf_counters();
+
+/**
+ * @brief Stop the hardware performance counters and keep their values for add_perf_counters
+ * @param iterations The number of executions of the algorithm counted since start_perf_counters
+ */
+void stop_perf_counters(int iterations);
+
+/**
+ * @brief Add the events per execution counted by the last measurement to the means of a sample point
+ * @param run The results of the sample point, whose counters are the means over the NUM_RUNS runs
+ */
+void add_perf_counters(RunResult *run);
+
 /**
  * @brief Set CPU affinity to the first core and increase the priority of the
  * process to the maximum
  */
 void set_cpu_affinity();
 
+/**
+ * @brief Increase the priority of the process to the maximum without pinning it
+ * to a core, for the benchmarks of the multithreaded algorithms
+ */
+void set_process_priority();
+
+/**
+ * @brief Parse the list of cores of the --cores option
+ * @param text the cores and inclusive ranges of cores separated by commas, e.g. "2,3,6-8", or an empty string
+ * @param cores the distinct cores in the order of the list, empty if the text is empty
+ * @return true if the list is valid and, on Linux, every core is one the process may run on (its affinity before
+ * set_cpu_affinity pinned it)
+ */
+bool parse_core_list(const std::string &text, std::vector<int> *cores);
+
+/**
+ * @brief Measure the sample points of a sweep, sharded across pinned worker processes
+ *
+ * Without cores, the points are measured in order by this process. Otherwise one worker process is forked per core
+ * (Linux only) and pinned to it, and the worker w measures the points w, w + cores.size(), ... so that every worker
+ * gets short and long arrays. The workers share no buffer: each one allocates its own on its first measurement, and
+ * opens its own hardware performance counters. The results are sent back through pipes.
+ *
+ * @param num_points the number of sample points
+ * @param cores the cores of the workers, empty to measure the points in this process
+ * @param result_size the size of a result in bytes
+ * @param measure the measurement of the point i, called as measure(i, result) in the process that measures it
+ * @param results the num_points results, in the order of the points
+ * @return true if every point was measured
+ */
+bool run_sweep_points(int num_points, const std::vector<int> &cores, size_t result_size,
+                      const std::function<void(int, void *)> &measure, void *results);
+
+/**
+ * @brief Measure the sample points of a sweep, sharded across pinned worker processes, see run_sweep_points
+ *
+ * The workers are forked: measure must not use threads started before the call, e.g. a TaskPool of several threads.
+ *
+ * @param sample_points the sample points
+ * @param cores the cores of the workers, empty to measure the points in this process
+ * @param results the results, in the order of the sample points
+ * @param measure the measurement of a sample point, called as measure(point) and returning its Result
+ * @return true if every point was measured
+ */
+template <class Result, class Measure>
+bool run_sweep(const std::vector<int> &sample_points, const std::vector<int> &cores, std::vector<Result> *results,
+               Measure measure) {
+    static_assert(std::is_trivially_copyable<Result>::value, "The results are sent back by the workers as bytes");
+    results->assign(sample_points.size(), Result{});
+    return run_sweep_points(
+            static_cast<int>(sample_points.size()), cores, sizeof(Result),
+            [&](const int i, void *result) { *static_cast<Result *>(result) = measure(sample_points[i]); },
+            results->data());
+}
+
+/**
+ * @brief Get the positional command-line arguments, skipping the options
+ * @param argc The number of command-line arguments
+ * @param argv The command-line arguments
+ * @return the arguments that do not start with "--", including the program name
+ */
+std::vector<std::string> get_positional_arguments(int argc, char *argv[]);
+
+/**
+ * @brief Get the value of a command-line option given as --name=value
+ * @param argc The number of command-line arguments
+ * @param argv The command-line arguments
+ * @param name The name of the option, without the leading "--"
+ * @param default_value The value to return if the option is not present
+ * @return the value of the option, or default_value if it is not present
+ */
+std::string get_option(int argc, char *argv[], const std::string &name, const std::string &default_value);
+
+/**
+ * @brief Check if a command-line flag given as --name is present
+ * @param argc The number of command-line arguments
+ * @param argv The command-line arguments
+ * @param name The name of the flag, without the leading "--"
+ * @return true if the flag is present
+ */
+bool has_flag(int argc, char *argv[], const std::string &name);
+
 /**
  * @brief Read array from stdin
  * @return the vector of integers read from stdin
  */
 std::vector<int> read_input_data();
 
+/**
+ * @brief Select what the timed loops of the benchmarks measure, TOTAL_TIMING by default
+ * @param mode the timing mode
+ */
+void set_timing_mode(TimingMode mode);
+
+/**
+ * @brief Get what the timed loops of the benchmarks measure
+ * @return the timing mode
+ */
+TimingMode get_timing_mode();
+
+/**
+ * @brief Get the timing mode selected by the --timing option
+ * @param name "total" for TOTAL_TIMING or "sort" for SORT_TIMING
+ * @param mode the timing mode, set if the name is known
+ * @return true if the name is known
+ */
+bool parse_timing_mode(const std::string &name, TimingMode *mode);
+
+/**
+ * @brief Get the number of inputs that measure_algorithm prepares at once
+ * @param bytes the size of the buffers of one input, in bytes
+ * @return 1 with TOTAL_TIMING; with SORT_TIMING, COPY_RING_SIZE or fewer so that the inputs fit in COPY_RING_BYTES
+ */
+int copy_ring_size(long long bytes);
+
+/**
+ * @brief Measure the overhead of the clock reads around an execution of the algorithm in SORT_TIMING
+ * @return the mean time of an empty timed region in nanoseconds, measured once
+ */
+double get_timer_overhead();
+
+/**
+ * @brief Keep the mean preparation time measured by measure_algorithm for add_copy_time
+ * @param time the mean time of the preparation of an input in nanoseconds
+ */
+void set_copy_time(double time);
+
+/**
+ * @brief Add the preparation time of the last measurement to the mean of a sample point, with SORT_TIMING
+ * @param run The results of the sample point, whose copy_time is the mean over the NUM_RUNS runs
+ */
+void add_copy_time(RunResult *run);
+
+/**
+ * @brief Measure the execution time of an algorithm, repeated until the time is measurable
+ *
+ * With TOTAL_TIMING, every iteration prepares the input and executes the algorithm, and the whole loop is timed.
+ * With SORT_TIMING, every iteration prepares the ring_size inputs of a ring of buffers, then executes the algorithm
+ * on each of them until the minimum time is reached; only the executions are timed, one at a time, between
+ * compiler fences, and the overhead of the clock reads measured by get_timer_overhead is subtracted. The mean time
+ * of the preparation of an input is kept for add_copy_time, and the hardware performance counters only count the
+ * executions.
+ *
+ * @param ring_size the number of inputs prepared at once, from copy_ring_size
+ * @param prepare the preparation of the input k of the ring, e.g. the copy of the data, called as prepare(k)
+ * @param execute the execution of the algorithm on the input k of the ring, called as execute(k)
+ * @return the mean execution time in nanoseconds
+ */
+template <class Prepare, class Execute>
+long long measure_algorithm(const int ring_size, Prepare prepare, Execute execute) {
+    // Get the resolution of the clock
+    const auto min_time = get_minimum_time();
+
+    // Initialize the clock to measure the execution time
+    long long elapsed = 0;
+    // Measure the elapsed time
+    int i = 0; // Counter to measure the number of iterations
+    if (get_timing_mode() == TOTAL_TIMING) {
+        // Count the hardware events of the timed loop, if enabled
+        start_perf_counters();
+        const time_point_t start = std::chrono::steady_clock::now(); // Start the clock
+        while (elapsed < min_time) { // Continue until the minimum time is reached
+            // Increment the counter
+            i++;
+
+            // Prepare the input and call the sort function
+            prepare(0);
+            execute(0);
+            // Measure the elapsed time
+            time_point_t end = std::chrono::steady_clock::now();
+            elapsed = std::chrono::duration_cast<time_unit_t>(end - start).count();
+        }
+        stop_perf_counters(i);
+
+        // Compute the elapsed time in nanoseconds
+        return elapsed / i;
+    }
+
+    const double overhead = get_timer_overhead();
+    double sort_time = 0, copy_time = 0;
+    int prepared = 0; // Number of inputs prepared, more than the executions if the last ring is not used up
+    start_perf_counters();
+    pause_perf_counters();
+    const time_point_t start = std::chrono::steady_clock::now(); // Start the clock
+    while (elapsed < min_time) { // Continue until the minimum time is reached
+        // Prepare the inputs of the ring
+        const time_point_t copy_start = std::chrono::steady_clock::now();
+        for (int k = 0; k < ring_size; k++) {
+            prepare(k);
+        }
+        prepared += ring_size;
+        const time_point_t copy_end = std::chrono::steady_clock::now();
+        copy_time += std::chrono::duration_cast<time_unit_t>(copy_end - copy_start).count();
+
+        // Time every execution alone, the fences keep the compiler from moving work across the clock reads
+        for (int k = 0; k < ring_size && elapsed < min_time; k++) {
+            i++;
+            resume_perf_counters();
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            const time_point_t sort_start = std::chrono::steady_clock::now();
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            execute(k);
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            const time_point_t sort_end = std::chrono::steady_clock::now();
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            pause_perf_counters();
+            sort_time += std::chrono::duration_cast<time_unit_t>(sort_end - sort_start).count() - overhead;
+
+            // Measure the elapsed time, the remaining inputs of the ring are not needed once it is reached
+            elapsed = std::chrono::duration_cast<time_unit_t>(sort_end - start).count();
+        }
+    }
+    stop_perf_counters(i);
+    set_copy_time(copy_time / prepared);
+
+    // Compute the execution time in nanoseconds, the subtraction of the overhead can make it slightly negative
+    return std::max(static_cast<long long>(sort_time / i), 0LL);
+}
+
 #endif